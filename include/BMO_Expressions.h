@@ -0,0 +1,238 @@
+/**
+ * @file BMO_Expressions.h
+ * @brief Expression engine that switches faces through precomputed region patches
+ *
+ * Expressions are defined in data/bmo_expressions.json as a face image per
+ * dynamic region. scripts/generate_expressions.py crops the regions and
+ * builds a transition table holding, for every (from, to) pair, only the
+ * regions that change and the smallest rectangle inside each that differs.
+ * A switch therefore costs one partial refresh over exactly those bytes, with
+ * no frame comparison at runtime.
+ *
+ * BmoTimelinePlayer plays the keyframed animation_sequences on top of the
+ * engine against absolute deadlines.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef BMO_EXPRESSIONS_H
+#define BMO_EXPRESSIONS_H
+
+#include "BMO_Face.h"
+#include "generated/bmo_expressions.h"
+
+/**
+ * @brief Tracks the expression on the panel and drives transitions
+ *
+ * The engine assumes it owns the expression regions: after anything else
+ * draws over them (full-screen image, clear), call invalidate() so the next
+ * setExpression() redraws every region instead of a transition delta.
+ */
+class BmoExpressionEngine {
+public:
+    BmoExpressionEngine() : current_(BMO_EXPRESSION_INITIAL), known_(false) {}
+
+    /**
+     * @brief Expression last drawn (BMO_EXPRESSION_INITIAL before the first)
+     */
+    BmoExpression current() const { return current_; }
+
+    /**
+     * @brief Check if the panel regions are known to show current()
+     */
+    bool isKnown() const { return known_; }
+
+    /**
+     * @brief Forget the panel state; the next switch redraws all regions
+     */
+    void invalidate() { known_ = false; }
+
+    /**
+     * @brief Mark the panel as already showing an expression (e.g. after drawing its face image)
+     */
+    void assume(BmoExpression expression) {
+        if (expression < BMO_EXPRESSION_COUNT) {
+            current_ = expression;
+            known_ = true;
+        }
+    }
+
+    /**
+     * @brief Switch to an expression with one partial refresh
+     * @param display Driver (any bus policy) in partial mode
+     * @param next Target expression
+     * @return true if the patches were written, or nothing changed
+     */
+    template <class Display>
+    bool setExpression(Display& display, BmoExpression next) {
+        if (next >= BMO_EXPRESSION_COUNT) {
+            return false;
+        }
+
+        const FacePatchList& plan = known_ ? transition(current_, next) : expression(next);
+        if (!display.updateFaceRegions(plan.patches, plan.count)) {
+            known_ = false;  // Regions may be half written
+            return false;
+        }
+
+        current_ = next;
+        known_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Patches that move the regions from one expression to another
+     */
+    static const FacePatchList& transition(BmoExpression from, BmoExpression to);
+
+    /**
+     * @brief Patches that draw every region of an expression
+     */
+    static const FacePatchList& expression(BmoExpression expression);
+
+    /**
+     * @brief Expression key from the JSON, or "?" if out of range
+     */
+    static const char* name(BmoExpression expression);
+
+private:
+    BmoExpression current_;     ///< Expression last drawn
+    bool known_;                ///< Panel regions match current_
+};
+
+/**
+ * @brief Timing statistics of a BmoTimelinePlayer
+ */
+struct TimelineStats {
+    unsigned long frames_shown;         ///< Keyframes drawn
+    unsigned long frames_skipped;       ///< Keyframes superseded before they could be drawn
+    unsigned long deadlines_missed;     ///< Drawn keyframes that started later than the tolerance
+    unsigned long max_lateness_ms;      ///< Worst start delay of a drawn keyframe
+};
+
+/**
+ * @brief Plays a FaceTimeline against absolute deadlines
+ *
+ * Keyframe deadlines are run_start + at_ms, and a repeating timeline moves
+ * run_start by exactly period_ms, so the schedule never drifts with SPI or
+ * waveform time. When a refresh overruns, every keyframe that has come due
+ * since is merged into one switch to the newest of them: the engine moves the
+ * panel straight there through the transition table and the rest are counted
+ * as skipped.
+ *
+ * Call update() from the main loop as often as convenient; it returns at once
+ * unless a keyframe is due.
+ */
+class BmoTimelinePlayer {
+public:
+    static constexpr unsigned long DEADLINE_TOLERANCE_MS = 20;  ///< Lateness still counted as on time
+
+    BmoTimelinePlayer() : timeline_(nullptr), run_start_(0), next_frame_(0) { resetStats(); }
+
+    /**
+     * @brief Start a timeline with its first keyframe due at now
+     * @param timeline Timeline to play (must outlive the playback)
+     * @param now Current time in ms (millis())
+     */
+    void start(const FaceTimeline& timeline, unsigned long now) {
+        timeline_ = timeline.frame_count > 0 ? &timeline : nullptr;
+        run_start_ = now;
+        next_frame_ = 0;
+    }
+
+    /**
+     * @brief Start a generated timeline by ID
+     */
+    void start(BmoAnimation animation, unsigned long now) { start(timeline(animation), now); }
+
+    /**
+     * @brief Stop playback; the panel keeps the last drawn keyframe
+     */
+    void stop() { timeline_ = nullptr; }
+
+    /**
+     * @brief Check if a timeline is playing
+     */
+    bool isPlaying() const { return timeline_ != nullptr; }
+
+    /**
+     * @brief Deadline of the next keyframe (valid while playing)
+     */
+    unsigned long nextDeadline() const { return run_start_ + timeline_->frames[next_frame_].at_ms; }
+
+    /**
+     * @brief Draw the newest due keyframe, if any
+     * @param display Driver in partial mode
+     * @param engine Engine that owns the expression regions
+     * @param now Current time in ms (millis())
+     * @return false only if drawing failed
+     */
+    template <class Display>
+    bool update(Display& display, BmoExpressionEngine& engine, unsigned long now) {
+        if (timeline_ == nullptr || (long)(now - nextDeadline()) < 0) {
+            return true;
+        }
+
+        // Merge everything due since the last call into the newest keyframe
+        unsigned long deadline = nextDeadline();
+        unsigned char expression = timeline_->frames[next_frame_].expression;
+        advance();
+        while (timeline_ != nullptr && (long)(now - nextDeadline()) >= 0) {
+            stats_.frames_skipped++;
+            deadline = nextDeadline();
+            expression = timeline_->frames[next_frame_].expression;
+            advance();
+        }
+
+        unsigned long lateness = now - deadline;
+        if (lateness > DEADLINE_TOLERANCE_MS) {
+            stats_.deadlines_missed++;
+        }
+        if (lateness > stats_.max_lateness_ms) {
+            stats_.max_lateness_ms = lateness;
+        }
+
+        stats_.frames_shown++;
+        return engine.setExpression(display, (BmoExpression)expression);
+    }
+
+    /**
+     * @brief Timing statistics since construction or resetStats()
+     */
+    const TimelineStats& stats() const { return stats_; }
+
+    /**
+     * @brief Clear the timing statistics
+     */
+    void resetStats() { memset(&stats_, 0, sizeof(stats_)); }
+
+    /**
+     * @brief Generated timeline for an animation sequence (frame_count 0 if out of range)
+     */
+    static const FaceTimeline& timeline(BmoAnimation animation);
+
+private:
+    const FaceTimeline* timeline_;      ///< Playing timeline, nullptr when stopped
+    unsigned long run_start_;           ///< Absolute start of the current run
+    unsigned char next_frame_;          ///< Next keyframe to draw
+    TimelineStats stats_;               ///< Timing statistics
+
+    /**
+     * @brief Step to the next keyframe, wrapping onto the period grid or finishing
+     */
+    void advance() {
+        if (++next_frame_ < timeline_->frame_count) {
+            return;
+        }
+        if (timeline_->period_ms == 0) {
+            timeline_ = nullptr;
+            return;
+        }
+        next_frame_ = 0;
+        run_start_ += timeline_->period_ms;
+    }
+};
+
+#endif // BMO_EXPRESSIONS_H
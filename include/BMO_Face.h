@@ -0,0 +1,57 @@
+/**
+ * @file BMO_Face.h
+ * @brief Application-level face types shared by the generated face tables
+ *
+ * FaceRegion itself lives in GDEH0154D67_Display.h because the driver updates
+ * regions directly; the types here only describe how regions are used.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef BMO_FACE_H
+#define BMO_FACE_H
+
+#include "GDEH0154D67_Display.h"
+
+/**
+ * @brief One entry of animation_sequences in data/bmo_face_regions.json
+ */
+struct FaceAnimationSequence {
+    const char* name;                   ///< Sequence key from the JSON
+    const FaceRegion* const* regions;   ///< Regions the sequence touches
+    unsigned char region_count;         ///< Entries in regions
+    unsigned int duration_ms;           ///< Intended duration of one run
+    const char* frequency;              ///< Trigger description from the JSON
+};
+
+/**
+ * @brief Patches that draw an expression or move between two expressions
+ * All patches go out with one partial refresh (GDEH0154D67::updateFaceRegions).
+ */
+struct FacePatchList {
+    const FaceRegionPatch* patches;     ///< First patch (nullptr if count is 0)
+    unsigned char count;                ///< Number of patches
+    unsigned int upload_bytes;          ///< RAM bytes sent to 0x24 (the 0x26 sync repeats them)
+};
+
+/**
+ * @brief One timeline step: show an expression at a fixed offset
+ */
+struct FaceKeyframe {
+    unsigned int at_ms;                 ///< Offset from the start of the sequence run
+    unsigned char expression;           ///< BmoExpression to show
+};
+
+/**
+ * @brief Keyframes that play one animation sequence
+ */
+struct FaceTimeline {
+    const FaceAnimationSequence* sequence;  ///< Sequence from bmo_face_regions.json
+    const FaceKeyframe* frames;         ///< Keyframes, at_ms strictly increasing
+    unsigned char frame_count;          ///< Entries in frames
+    unsigned int period_ms;             ///< Repeat interval, 0 = play once
+};
+
+#endif // BMO_FACE_H
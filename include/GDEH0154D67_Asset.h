@@ -0,0 +1,106 @@
+/**
+ * @file GDEH0154D67_Asset.h
+ * @brief Compressed image container and streaming decoder for the GDEH0154D67 display
+ *
+ * Images are stored LZ-compressed with a 256-byte history window so the decoder
+ * never needs more than the window plus the caller's output chunk. The driver
+ * pulls small chunks from the decoder and streams them straight into the RAM
+ * write (0x24/0x26), so a full frame is never materialized in RAM.
+ *
+ * Container layout (little endian):
+ *   [0..2] 'B' 'M' 'Z'   magic
+ *   [3]    kind          ASSET_MONO (5000 bytes for 0x24) or
+ *                        ASSET_GRAY_PLANES (5000 bytes 0x24, then 5000 bytes 0x26)
+ *   [4..5] raw length    decoded byte count
+ *   [6..7] payload length compressed byte count following the header
+ *
+ * Payload tokens:
+ *   0x00-0x7F  literal run, (token + 1) bytes follow
+ *   0x80-0xFF  match of (token & 0x7F) + 3 bytes, followed by one offset byte;
+ *              the match copies from (offset + 1) bytes back in the output
+ *
+ * Containers are produced offline by scripts/compress_assets.py.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef GDEH0154D67_ASSET_H
+#define GDEH0154D67_ASSET_H
+
+#include "GDEH0154D67_Platform.h"
+
+/**
+ * @brief Pull-style decoder for one compressed image container
+ *
+ * Holds only the history window and the token state (~270 bytes). The source
+ * may live in RAM or PROGMEM.
+ */
+class GDEH0154D67_AssetDecoder {
+public:
+    static constexpr unsigned char ASSET_MONO = 1;         ///< One 1bpp plane for RAM 0x24
+    static constexpr unsigned char ASSET_GRAY_PLANES = 2;  ///< Pre-split 0x24 plane followed by 0x26 plane
+    static constexpr size_t HEADER_SIZE = 8;               ///< Container header bytes
+    static constexpr size_t WINDOW_SIZE = 256;             ///< History window (max match distance)
+
+    GDEH0154D67_AssetDecoder();
+
+    /**
+     * @brief Start decoding a container
+     * @param asset Pointer to the container header (RAM or PROGMEM)
+     * @return true if the header is valid
+     */
+    bool begin(const unsigned char* asset);
+
+    /**
+     * @brief Decode up to max_length bytes
+     * @param out Destination buffer
+     * @param max_length Capacity of out
+     * @return Bytes written; less than max_length only at the end or on error
+     */
+    size_t read(unsigned char* out, size_t max_length);
+
+    /**
+     * @brief Container kind from the header (ASSET_MONO, ASSET_GRAY_PLANES)
+     */
+    unsigned char kind() const { return kind_; }
+
+    /**
+     * @brief Decoded size from the header
+     */
+    size_t rawLength() const { return raw_length_; }
+
+    /**
+     * @brief Check if all raw bytes have been produced
+     */
+    bool isDone() const { return produced_ == raw_length_ && !failed_; }
+
+    /**
+     * @brief Check if the payload was truncated or referenced data before its start
+     */
+    bool hasFailed() const { return failed_; }
+
+private:
+    const unsigned char* payload_;      ///< First payload byte
+    size_t payload_length_;             ///< Payload bytes
+    size_t payload_pos_;                ///< Next payload byte to read
+    size_t raw_length_;                 ///< Bytes the container decodes to
+    size_t produced_;                   ///< Bytes decoded so far
+    unsigned char kind_;                ///< Container kind
+    bool failed_;                       ///< Corrupt or truncated payload
+
+    unsigned int literal_left_;         ///< Literal bytes left in the current token
+    unsigned int match_left_;           ///< Match bytes left in the current token
+    unsigned int match_distance_;       ///< Distance of the current match (1-256)
+
+    unsigned char window_[WINDOW_SIZE]; ///< Last 256 output bytes
+    unsigned char window_pos_;          ///< Next write position, wraps at 256
+
+    /**
+     * @brief Read the next payload byte, flagging truncation
+     */
+    unsigned char nextPayloadByte();
+};
+
+#endif // GDEH0154D67_ASSET_H
@@ -0,0 +1,99 @@
+/**
+ * @file GDEH0154D67_AssetPack.h
+ * @brief Indexed asset pack accessed zero-copy from a flash data partition
+ *
+ * Images live in their own "assets" data partition instead of the firmware
+ * image, so artwork can be reflashed without rebuilding the application. On
+ * the ESP32 the partition is mapped into the data address space with
+ * esp_partition_mmap() and entries are handed to the driver as plain pointers;
+ * on the host the same pack file is mapped with POSIX mmap().
+ *
+ * Pack layout (little endian), written by scripts/pack_assets.py:
+ *   [0..3]  'B' 'M' 'O' 'P'  magic
+ *   [4..5]  version (1)
+ *   [6..7]  entry count
+ *   [8..]   entries, 12 bytes each: id (u16), kind (u8), reserved (u8),
+ *           offset from pack start (u32), length (u32)
+ *   blobs   4-byte aligned
+ *
+ * Asset IDs are generated into include/generated/asset_ids.h.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef GDEH0154D67_ASSETPACK_H
+#define GDEH0154D67_ASSETPACK_H
+
+#include "GDEH0154D67_Platform.h"
+
+/**
+ * @brief Read-only view of a mapped asset pack
+ */
+class GDEH0154D67_AssetPack {
+public:
+    static constexpr unsigned char KIND_MONO = 1;        ///< Raw 5000-byte frame for RAM 0x24
+    static constexpr unsigned char KIND_GRAY_PLANES = 2; ///< Raw 0x24 plane followed by 0x26 plane
+    static constexpr unsigned char KIND_COMPRESSED = 3;  ///< Container for GDEH0154D67_AssetDecoder
+    static constexpr unsigned char KIND_DELTA = 4;       ///< XOR frame delta for applyFrameDelta()
+    static constexpr unsigned int VERSION = 1;           ///< Supported pack version
+    static constexpr size_t HEADER_SIZE = 8;             ///< Magic, version, entry count
+    static constexpr size_t ENTRY_SIZE = 12;             ///< Bytes per index entry
+
+    GDEH0154D67_AssetPack();
+    ~GDEH0154D67_AssetPack();
+
+    /**
+     * @brief Map a pack and validate its index
+     * @param name Partition label on the ESP32 (e.g. "assets"), file path on the host
+     * @return true if the pack is mapped and every entry lies inside it
+     */
+    bool open(const char* name);
+
+    /**
+     * @brief Unmap the pack; pointers returned by find() become invalid
+     */
+    void close();
+
+    /**
+     * @brief Check if a pack is mapped
+     */
+    bool isOpen() const { return data_ != nullptr; }
+
+    /**
+     * @brief Number of entries in the index
+     */
+    unsigned int entryCount() const { return entry_count_; }
+
+    /**
+     * @brief Look up an asset by ID
+     * @param id Asset ID from generated/asset_ids.h
+     * @param kind Optional output for the entry kind (KIND_*)
+     * @param length Optional output for the blob length
+     * @return Pointer into the mapped pack, or nullptr if the ID is unknown
+     */
+    const unsigned char* find(unsigned int id, unsigned char* kind = nullptr, size_t* length = nullptr) const;
+
+private:
+    const unsigned char* data_;   ///< Mapped pack
+    size_t size_;                 ///< Mapped bytes
+    unsigned int entry_count_;    ///< Index entries
+
+    uint32_t map_handle_;         ///< ESP-IDF mmap handle (unused on the host)
+
+    GDEH0154D67_AssetPack(const GDEH0154D67_AssetPack&) = delete;
+    GDEH0154D67_AssetPack& operator=(const GDEH0154D67_AssetPack&) = delete;
+
+    /**
+     * @brief Check the header and that all entries lie inside the mapping
+     */
+    bool validate();
+
+    static unsigned int readU16(const unsigned char* p) { return p[0] | (p[1] << 8); }
+    static unsigned long readU32(const unsigned char* p) {
+        return (unsigned long)p[0] | ((unsigned long)p[1] << 8) | ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+    }
+};
+
+#endif // GDEH0154D67_ASSETPACK_H
@@ -0,0 +1,426 @@
+/**
+ * @file GDEH0154D67_Bus.h
+ * @brief Compile-time bus/pin policies for the GDEH0154D67 display driver
+ *
+ * The display driver is a template over one of these policies:
+ *
+ * - BitBangBus<BUSY, RST, DC, CS, SCK, SDI>  software SPI on direct GPIO registers
+ * - HwSpiBus<BUSY, RST, DC, CS, SCK, SDI>    VSPI/HSPI + DMA, bit-bang fallback
+ * - SimBus                                   host-side simulated bus
+ *
+ * Pin numbers are template arguments, so every control-line edge compiles down
+ * to a single store into the ESP32 GPIO set/clear registers with a constant
+ * mask. There is no virtual dispatch between the driver and a hardware bus.
+ *
+ * On the ESP32 the BUSY pin gets a falling-edge interrupt that wakes the waiting
+ * task through a FreeRTOS task notification, so waitIdle() sleeps instead of
+ * polling for the whole 0.3-4 s waveform.
+ *
+ * Every policy provides the same interface:
+ * @code
+ *   bool begin(bool prefer_hardware_spi);   // configure pins / peripheral
+ *   bool isHardwareSpi() const;
+ *   void csActive();  void csInactive();    // CS low / high
+ *   void dcCommand(); void dcData();        // DC low / high
+ *   void rstActive(); void rstInactive();   // RST low / high
+ *   bool busy();                            // BUSY pin is high
+ *   bool waitIdle(unsigned long timeout_ms); // block until BUSY is low (0 = no timeout)
+ *   void write(uint8_t value);              // one byte, current DC level
+ *   void writeBlock(const uint8_t* data, size_t length); // RAM or PROGMEM
+ *   void delayMs(unsigned long ms);
+ *   unsigned long millis();
+ *   unsigned long micros();
+ * @endcode
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef GDEH0154D67_BUS_H
+#define GDEH0154D67_BUS_H
+
+#include "GDEH0154D67_Platform.h"
+
+#ifdef ARDUINO
+
+#include <soc/gpio_struct.h>
+#include "GDEH0154D67_HwSpi.h"
+
+// ===== DIRECT GPIO ACCESS =====
+
+/**
+ * @brief Constant-folded access to one ESP32 GPIO through the W1TS/W1TC registers
+ * @tparam PIN GPIO number (0-39)
+ */
+template <int PIN>
+struct GpioPin {
+    static_assert(PIN >= 0 && PIN < 40, "ESP32 GPIO number out of range");
+
+    static constexpr uint32_t MASK = 1UL << (PIN & 31); ///< Bit within the GPIO bank
+
+    static inline void high() {
+        if (PIN < 32) {
+            GPIO.out_w1ts = MASK;
+        } else {
+            GPIO.out1_w1ts.val = MASK;
+        }
+    }
+
+    static inline void low() {
+        if (PIN < 32) {
+            GPIO.out_w1tc = MASK;
+        } else {
+            GPIO.out1_w1tc.val = MASK;
+        }
+    }
+
+    static inline bool read() {
+        return PIN < 32 ? (GPIO.in & MASK) != 0 : (GPIO.in1.val & MASK) != 0;
+    }
+};
+
+// ===== BUSY INTERRUPT =====
+
+/**
+ * @brief Falling-edge interrupt on BUSY that wakes the waiting task
+ * @tparam PIN BUSY GPIO number
+ *
+ * The waiter registers itself before re-checking the pin level, so an edge
+ * between the check and the sleep still wakes it. Uses the default notification
+ * slot of the waiting task; a stray notification only costs one extra level check.
+ */
+template <int PIN>
+class BusyInterrupt {
+public:
+    static constexpr unsigned long RECHECK_MS = 100; ///< Level re-check period if an edge is missed
+
+    /**
+     * @brief Attach the ISR (idempotent)
+     */
+    static void attach() {
+        if (!attached_) {
+            attachInterruptArg(digitalPinToInterrupt(PIN), onFallingEdge, nullptr, FALLING);
+            attached_ = true;
+        }
+    }
+
+    /**
+     * @brief Sleep until BUSY is low
+     * @param timeout_ms Maximum wait in milliseconds (0 = infinite)
+     * @return true if BUSY is low, false on timeout
+     */
+    static bool waitIdle(unsigned long timeout_ms) {
+        unsigned long start_time = ::millis();
+
+        while (GpioPin<PIN>::read()) {
+            unsigned long waited = ::millis() - start_time;
+            if (timeout_ms > 0 && waited >= timeout_ms) {
+                waiter_ = nullptr;
+                return false;
+            }
+
+            // No ISR, or called before the scheduler runs: fall back to polling
+            if (!attached_ || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+                ::delay(1);
+                continue;
+            }
+
+            unsigned long sleep_ms = RECHECK_MS;
+            if (timeout_ms > 0 && timeout_ms - waited < sleep_ms) {
+                sleep_ms = timeout_ms - waited;
+            }
+
+            waiter_ = xTaskGetCurrentTaskHandle();
+            if (!GpioPin<PIN>::read()) {
+                break;  // Edge happened before we registered
+            }
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleep_ms) + 1);
+        }
+
+        waiter_ = nullptr;
+        return true;
+    }
+
+private:
+    static void IRAM_ATTR onFallingEdge(void* arg) {
+        (void)arg;
+        TaskHandle_t waiter = waiter_;
+        if (waiter != nullptr) {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(waiter, &woken);
+            if (woken == pdTRUE) {
+                portYIELD_FROM_ISR();
+            }
+        }
+    }
+
+    static volatile TaskHandle_t waiter_; ///< Task sleeping in waitIdle(), if any
+    static bool attached_;                ///< ISR installed
+};
+
+template <int PIN>
+volatile TaskHandle_t BusyInterrupt<PIN>::waiter_ = nullptr;
+
+template <int PIN>
+bool BusyInterrupt<PIN>::attached_ = false;
+
+// ===== BIT-BANGED SPI =====
+
+/**
+ * @brief Software SPI on arbitrary GPIOs
+ * @note SSD1681 needs SCK high/low phases of at least 20ns; at 240MHz a
+ *       register store plus a few NOPs keeps each phase above that
+ */
+template <int BUSY, int RST, int DC, int CS, int SCK, int SDI>
+class BitBangBus {
+public:
+    bool begin(bool prefer_hardware_spi = false) {
+        (void)prefer_hardware_spi;
+        beginControlPins();
+        pinMode(SCK, OUTPUT);   // SPI Clock output
+        pinMode(SDI, OUTPUT);   // SPI Data output
+        return false;
+    }
+
+    /**
+     * @brief Configure BUSY/RST/DC/CS only (shared with HwSpiBus)
+     */
+    static void beginControlPins() {
+        pinMode(BUSY, INPUT);   // BUSY is an input from display
+        pinMode(RST, OUTPUT);   // Reset control output
+        pinMode(DC, OUTPUT);    // Data/Command control output
+        pinMode(CS, OUTPUT);    // SPI Chip Select output
+        BusyInterrupt<BUSY>::attach();
+    }
+
+    bool isHardwareSpi() const { return false; }
+
+    void csActive() { GpioPin<CS>::low(); }
+    void csInactive() { GpioPin<CS>::high(); }
+    void dcCommand() { GpioPin<DC>::low(); }
+    void dcData() { GpioPin<DC>::high(); }
+    void rstActive() { GpioPin<RST>::low(); }
+    void rstInactive() { GpioPin<RST>::high(); }
+    bool busy() { return GpioPin<BUSY>::read(); }
+    bool waitIdle(unsigned long timeout_ms) { return BusyInterrupt<BUSY>::waitIdle(timeout_ms); }
+
+    void write(uint8_t value) {
+        // Send 8 bits MSB first, data sampled on the rising edge
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            GpioPin<SCK>::low();
+            if (value & 0x80) {
+                GpioPin<SDI>::high();
+            } else {
+                GpioPin<SDI>::low();
+            }
+            value <<= 1;
+            clockDelay();
+            GpioPin<SCK>::high();
+            clockDelay();
+        }
+    }
+
+    void writeBlock(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            write(pgm_read_byte(&data[i]));
+        }
+    }
+
+    void delayMs(unsigned long ms) { ::delay(ms); }
+    unsigned long millis() { return ::millis(); }
+    unsigned long micros() { return ::micros(); }
+
+private:
+    static inline void clockDelay() {
+        __asm__ __volatile__("nop; nop; nop; nop; nop; nop; nop; nop;");
+    }
+};
+
+// ===== HARDWARE SPI + DMA =====
+
+/**
+ * @brief VSPI/HSPI transport with DMA for bulk data, bit-bang fallback
+ *
+ * Control lines use direct GPIO registers like BitBangBus. Data bytes written
+ * one at a time are batched while CS is held and flushed as one transfer when
+ * DC changes, CS is released or a block follows.
+ */
+template <int BUSY, int RST, int DC, int CS, int SCK, int SDI>
+class HwSpiBus {
+public:
+    static constexpr size_t BATCH_SIZE = 128; ///< Bytes batched before a DMA transfer
+
+    HwSpiBus() : use_hw_(false), fill_(0) {}
+
+    bool begin(bool prefer_hardware_spi = true) {
+        BitBangBus<BUSY, RST, DC, CS, SCK, SDI>::beginControlPins();
+        use_hw_ = prefer_hardware_spi && spi_.begin(SCK, SDI);
+        if (!use_hw_) {
+            fallback_.begin(false);  // SCK/SDI stay plain GPIOs
+        }
+        return use_hw_;
+    }
+
+    bool isHardwareSpi() const { return use_hw_; }
+
+    void csActive() { GpioPin<CS>::low(); }
+    void csInactive() { flush(); GpioPin<CS>::high(); }
+    void dcCommand() { flush(); GpioPin<DC>::low(); }
+    void dcData() { flush(); GpioPin<DC>::high(); }
+    void rstActive() { GpioPin<RST>::low(); }
+    void rstInactive() { GpioPin<RST>::high(); }
+    bool busy() { return GpioPin<BUSY>::read(); }
+    bool waitIdle(unsigned long timeout_ms) { return BusyInterrupt<BUSY>::waitIdle(timeout_ms); }
+
+    void write(uint8_t value) {
+        if (!use_hw_) {
+            fallback_.write(value);
+            return;
+        }
+        batch_[fill_++] = value;
+        if (fill_ == BATCH_SIZE) {
+            flush();
+        }
+    }
+
+    void writeBlock(const uint8_t* data, size_t length) {
+        if (!use_hw_) {
+            fallback_.writeBlock(data, length);
+            return;
+        }
+        flush();  // Keep byte order
+        spi_.writeBuffer(data, length);
+    }
+
+    void delayMs(unsigned long ms) { ::delay(ms); }
+    unsigned long millis() { return ::millis(); }
+    unsigned long micros() { return ::micros(); }
+
+private:
+    void flush() {
+        if (fill_ > 0) {
+            spi_.writeBuffer(batch_, fill_);
+            fill_ = 0;
+        }
+    }
+
+    GDEH0154D67_HwSpi spi_;                       ///< Peripheral + DMA buffers
+    BitBangBus<BUSY, RST, DC, CS, SCK, SDI> fallback_; ///< Used for odd pin maps
+    bool use_hw_;                                 ///< Whether spi_ is active
+    uint8_t batch_[BATCH_SIZE];                   ///< Pending single-byte writes
+    size_t fill_;                                 ///< Number of pending bytes
+};
+
+#endif // ARDUINO
+
+// ===== SIMULATED BUS (HOST) =====
+
+/**
+ * @brief Receiver for the byte stream of a SimBus
+ *
+ * Implemented by host-side models of the SSD1681 (emulator, counters). Time is
+ * virtual: it only advances when the driver waits.
+ */
+class SimBusDevice {
+public:
+    virtual ~SimBusDevice() {}
+
+    /** @brief Command byte received (DC low) */
+    virtual void onCommand(uint8_t command) = 0;
+
+    /** @brief Data bytes received (DC high) */
+    virtual void onData(const uint8_t* data, size_t length) = 0;
+
+    /** @brief CS edge (true = asserted/low) */
+    virtual void onChipSelect(bool active) { (void)active; }
+
+    /** @brief RST edge (true = asserted/low) */
+    virtual void onReset(bool active) { (void)active; }
+
+    /** @brief Current level of the BUSY pin */
+    virtual bool isBusy() { return false; }
+
+    /** @brief Virtual time advanced by the given number of milliseconds */
+    virtual void onDelay(unsigned long ms) { (void)ms; }
+};
+
+/**
+ * @brief Bus policy that forwards the driver's traffic to a SimBusDevice
+ */
+class SimBus {
+public:
+    SimBus() : device_(nullptr), cs_active_(false), dc_data_(false), now_ms_(0) {}
+
+    /**
+     * @brief Connect the simulated panel
+     * @param device Receiver for all bus traffic (nullptr = discard)
+     */
+    void attach(SimBusDevice* device) { device_ = device; }
+    SimBusDevice* device() const { return device_; }
+
+    bool begin(bool prefer_hardware_spi = true) { (void)prefer_hardware_spi; return false; }
+    bool isHardwareSpi() const { return false; }
+
+    void csActive() { cs_active_ = true; if (device_) device_->onChipSelect(true); }
+    void csInactive() { cs_active_ = false; if (device_) device_->onChipSelect(false); }
+    void dcCommand() { dc_data_ = false; }
+    void dcData() { dc_data_ = true; }
+    void rstActive() { if (device_) device_->onReset(true); }
+    void rstInactive() { if (device_) device_->onReset(false); }
+    bool busy() { return device_ != nullptr && device_->isBusy(); }
+
+    /**
+     * @brief Advance virtual time until the device releases BUSY
+     */
+    bool waitIdle(unsigned long timeout_ms) {
+        unsigned long start_time = now_ms_;
+        while (busy()) {
+            if (timeout_ms > 0 && now_ms_ - start_time >= timeout_ms) {
+                return false;
+            }
+            delayMs(1);
+        }
+        return true;
+    }
+
+    void write(uint8_t value) {
+        if (!cs_active_ || device_ == nullptr) {
+            return;  // Panel ignores the bus while deselected
+        }
+        if (dc_data_) {
+            device_->onData(&value, 1);
+        } else {
+            device_->onCommand(value);
+        }
+    }
+
+    void writeBlock(const uint8_t* data, size_t length) {
+        if (!cs_active_ || device_ == nullptr) {
+            return;
+        }
+        if (dc_data_) {
+            device_->onData(data, length);
+        } else {
+            for (size_t i = 0; i < length; i++) {
+                device_->onCommand(data[i]);
+            }
+        }
+    }
+
+    void delayMs(unsigned long ms) {
+        now_ms_ += ms;
+        if (device_) device_->onDelay(ms);
+    }
+
+    unsigned long millis() { return now_ms_; }
+    unsigned long micros() { return now_ms_ * 1000; }  ///< Bus traffic takes no virtual time
+
+private:
+    SimBusDevice* device_;   ///< Attached panel model
+    bool cs_active_;         ///< CS asserted
+    bool dc_data_;           ///< DC high (data)
+    unsigned long now_ms_;   ///< Virtual time in milliseconds
+};
+
+#endif // GDEH0154D67_BUS_H
@@ -18,7 +18,9 @@
  * - 4-grayscale mode support
  * - Multi-region partial updates
  * - Hardware SPI and bit-banged SPI support
+ * - Compile-time bus/pin policies (see GDEH0154D67_Bus.h), including a host-side simulated bus
  * - Comprehensive error handling and busy state monitoring
+ * - Interrupt-driven BUSY wait and non-blocking refresh handles
  * 
  * @author Generated from manufacturer code
  * @date 2025
@@ -28,7 +30,10 @@
 #ifndef GDEH0154D67_DISPLAY_H
 #define GDEH0154D67_DISPLAY_H
 
-#include <Arduino.h>
+#include "GDEH0154D67_Platform.h"
+#include "GDEH0154D67_Bus.h"
+#include "GDEH0154D67_Asset.h"
+#include "GDEH0154D67_AssetPack.h"
 
 /**
  * @brief Structure defining a partial refresh region
@@ -57,40 +62,623 @@ struct PartialRegion {
     bool isValid() const { return width > 0 && height > 0 && data != nullptr; }
 };
 
+/**
+ * @brief Byte-aligned rectangle in frame coordinates (row 0 = top of panel)
+ */
+struct FrameRect {
+    unsigned int x_start_byte;   ///< First byte column (0-24)
+    unsigned int x_end_byte;     ///< Last byte column, inclusive
+    unsigned int row_start;      ///< First row (0-199)
+    unsigned int row_end;        ///< Last row, inclusive
+    
+    constexpr FrameRect() : x_start_byte(0), x_end_byte(0), row_start(0), row_end(0) {}
+    
+    constexpr FrameRect(unsigned int x0, unsigned int x1, unsigned int r0, unsigned int r1)
+        : x_start_byte(x0), x_end_byte(x1), row_start(r0), row_end(r1) {}
+    
+    /**
+     * @brief Number of RAM bytes covered by the rectangle
+     */
+    constexpr unsigned int byteCount() const { return (x_end_byte - x_start_byte + 1) * (row_end - row_start + 1); }
+    
+    /**
+     * @brief Check if the rectangles share at least one byte
+     */
+    constexpr bool overlaps(const FrameRect& other) const {
+        return x_start_byte <= other.x_end_byte && other.x_start_byte <= x_end_byte &&
+               row_start <= other.row_end && other.row_start <= row_end;
+    }
+};
+
+/**
+ * @brief Compile-time face region with precomputed RAM window command bytes
+ * Generated from data/bmo_face_regions.json by scripts/generate_regions_header.py.
+ * Rows are frame rows (0 = top); the window bytes address them the way the
+ * partial path does (RAM Y = 199 - row, Y increment), so updates need no
+ * coordinate math at runtime.
+ */
+struct FaceRegion {
+    const char* name;                ///< Region key from the JSON
+    unsigned char x_start_byte;      ///< First byte column (0-24)
+    unsigned char x_end_byte;        ///< Last byte column, inclusive
+    unsigned char row_start;         ///< First frame row (0-199)
+    unsigned char row_end;           ///< Last frame row, inclusive
+    unsigned char ram_x_window[2];   ///< 0x44 arguments
+    unsigned char ram_y_window[4];   ///< 0x45 arguments
+    unsigned char ram_x_counter;     ///< 0x4E argument
+    unsigned char ram_y_counter[2];  ///< 0x4F arguments
+    unsigned char priority;          ///< 0 = low, 1 = medium, 2 = high
+    unsigned char update_mode;       ///< Display update control value of its refresh strategy
+    unsigned char ghosting_threshold; ///< Partial updates before a cleanup is advised
+    
+    /**
+     * @brief RAM bytes covered by the region (size of its image data)
+     */
+    constexpr unsigned int byteCount() const {
+        return (x_end_byte - x_start_byte + 1) * (row_end - row_start + 1);
+    }
+    
+    /**
+     * @brief Bounds and window bytes are consistent; used by static_assert
+     */
+    constexpr bool isValid() const {
+        return x_start_byte <= x_end_byte && x_end_byte < 25 && row_start <= row_end && row_end < 200 &&
+               ram_x_window[0] == x_start_byte && ram_x_window[1] == x_end_byte &&
+               ram_y_window[0] == 199 - row_end && ram_y_window[1] == 0 &&
+               ram_y_window[2] == 199 - row_start && ram_y_window[3] == 0 &&
+               ram_x_counter == x_start_byte &&
+               ram_y_counter[0] == ram_y_window[0] && ram_y_counter[1] == ram_y_window[1];
+    }
+};
+
+/**
+ * @brief Part of a face region's image to upload
+ * The image always covers the whole region; rect selects the bytes that are
+ * sent, so a transition can upload only what differs inside the region.
+ */
+struct FaceRegionPatch {
+    const FaceRegion* region;        ///< Region the image belongs to
+    const unsigned char* data;       ///< region->byteCount() bytes, bottom row first
+    FrameRect rect;                  ///< Frame rectangle to upload, inside the region
+};
+
+/**
+ * @brief Transfer cost estimate used to plan RAM windows
+ * Defaults correspond to hardware SPI at 20MHz with polled register writes.
+ */
+struct TransferCostModel {
+    float byte_us;               ///< Wire time per data byte in microseconds
+    float transaction_us;        ///< Fixed cost per CS transaction (one command or argument byte)
+    
+    TransferCostModel() : byte_us(0.4f), transaction_us(10.0f) {}
+    TransferCostModel(float per_byte, float per_transaction)
+        : byte_us(per_byte), transaction_us(per_transaction) {}
+};
+
+/**
+ * @brief 4-grayscale image stored as the two controller plane images
+ * Both planes are already split and inverted, exactly as displayFullScreen4Gray()
+ * would send them. Generated at build time by scripts/presplit_gray_assets.py.
+ */
+struct GrayPlaneImage {
+    const unsigned char* ram_24;  ///< 5000 bytes for RAM 0x24 (RAM or PROGMEM)
+    const unsigned char* ram_26;  ///< 5000 bytes for RAM 0x26 (RAM or PROGMEM)
+};
+
+/**
+ * @brief Waveform used by a full refresh
+ */
+enum FullRefreshMode : unsigned char {
+    FULL_REFRESH_NORMAL,   ///< OTP waveform for the measured temperature (0x22 = 0xF7), 2-4 s
+    FULL_REFRESH_FAST      ///< OTP waveform for a forced high temperature (0x1A), ~1-1.5 s, slightly more ghosting
+};
+
+/**
+ * @brief Waveform used by a partial refresh
+ */
+enum PartialWaveform : unsigned char {
+    PARTIAL_WAVEFORM_OTP,  ///< OTP waveform reloaded for every update (0x22 = 0xFF), ~0.4 s
+    PARTIAL_WAVEFORM_FAST  ///< Short custom mono LUT loaded once (0x22 = 0xCF), ~0.15 s, ghosts sooner
+};
+
+/**
+ * @brief Controller configuration selected with switchMode()
+ */
+enum DisplayMode : unsigned char {
+    DISPLAY_MODE_MONO,     ///< Register setup of initializeMonochrome()
+    DISPLAY_MODE_GRAY      ///< Register setup and LUT of initialize4Grayscale()
+};
+
+/**
+ * @brief One controller command of a precompiled init sequence
+ */
+struct InitCommand {
+    unsigned char opcode;        ///< Command byte
+    unsigned char arg_count;     ///< Bytes used from args
+    unsigned char args[4];       ///< Arguments, sent as one block
+    bool wait_busy;              ///< Wait for BUSY low after the command
+};
+
+/**
+ * @brief Completion handle for an asynchronous refresh
+ */
+struct RefreshHandle {
+    unsigned long id;            ///< Sequence number of the refresh (0 = none started)
+    
+    RefreshHandle() : id(0) {}
+    explicit RefreshHandle(unsigned long i) : id(i) {}
+    
+    /**
+     * @brief Check if a refresh was actually started
+     */
+    bool isValid() const { return id != 0; }
+};
+
+/**
+ * @brief Completion callback for asynchronous refreshes
+ * @param handle Handle returned when the refresh was started
+ * @param context User pointer passed to the async call
+ * @note Runs in the task that calls poll(), waitRefresh() or the next display
+ *       operation - never in interrupt context
+ */
+typedef void (*RefreshCallback)(RefreshHandle handle, void* context);
+
+/**
+ * @brief Bus-independent part of the display driver
+ * 
+ * Holds the panel constants, error/debug state and the pure data helpers so they
+ * are compiled once, no matter how many bus policies the driver is instantiated with.
+ */
+class GDEH0154D67_Base {
+public:
+    // ===== UTILITY FUNCTIONS =====
+    
+    /**
+     * @brief Get display width in pixels
+     * @return Display width (200 pixels)
+     */
+    static constexpr unsigned int getWidth() { return DISPLAY_WIDTH; }
+    
+    /**
+     * @brief Get display height in pixels  
+     * @return Display height (200 pixels)
+     */
+    static constexpr unsigned int getHeight() { return DISPLAY_HEIGHT; }
+    
+    /**
+     * @brief Get full screen buffer size in bytes
+     * @return Buffer size for monochrome mode (5000 bytes)
+     */
+    static constexpr unsigned int getMonoBufferSize() { return MONO_BUFFER_SIZE; }
+    
+    /**
+     * @brief Get 4-grayscale buffer size in bytes
+     * @return Buffer size for 4-gray mode (10000 bytes)  
+     */
+    static constexpr unsigned int getGrayBufferSize() { return GRAY_BUFFER_SIZE; }
+
+    // ===== INIT SEQUENCES =====
+    // Register programs sent after the hardware reset, with CS held between BUSY
+    // waits. Public so host builds can check them against the emulator.
+    
+    /**
+     * @brief initializeMonochrome(): 200 gate lines, X+/Y-, full window, border follows content
+     */
+    static constexpr InitCommand INIT_SEQUENCE_MONO[] = {
+        { 0x12, 0, { 0 }, true },                       // SWRESET
+        { 0x01, 3, { 0xC7, 0x00, 0x00 }, false },       // Driver output control: 200 lines
+        { 0x11, 1, { 0x01 }, false },                   // Data entry mode: X increment, Y decrement
+        { 0x44, 2, { 0x00, 0x18 }, false },             // RAM X window 0-24
+        { 0x45, 4, { 0xC7, 0x00, 0x00, 0x00 }, false }, // RAM Y window 199-0 (bottom-up)
+        { 0x3C, 1, { 0x05 }, false },                   // Border follows display content
+        { 0x18, 1, { 0x80 }, false },                   // Internal temperature sensor
+        { 0x4E, 1, { 0x00 }, false },                   // RAM X counter
+        { 0x4F, 2, { 0xC7, 0x00 }, true }               // RAM Y counter 199, final ready check
+    };
+    static constexpr size_t INIT_SEQUENCE_MONO_LENGTH = sizeof(INIT_SEQUENCE_MONO) / sizeof(INIT_SEQUENCE_MONO[0]);
+    
+    /**
+     * @brief initialize4Grayscale() before its LUT: mono addressing, tuned analog/digital blocks, fixed border
+     */
+    static constexpr InitCommand INIT_SEQUENCE_GRAY[] = {
+        { 0x12, 0, { 0 }, true },                       // SWRESET
+        { 0x74, 1, { 0x54 }, false },                   // Analog block control
+        { 0x7E, 1, { 0x3B }, false },                   // Digital block control
+        { 0x01, 3, { 0xC7, 0x00, 0x00 }, false },       // Driver output control: 200 lines
+        { 0x11, 1, { 0x01 }, false },                   // Data entry mode: X increment, Y decrement
+        { 0x44, 2, { 0x00, 0x18 }, false },             // RAM X window 0-24
+        { 0x45, 4, { 0xC7, 0x00, 0x00, 0x00 }, false }, // RAM Y window 199-0
+        { 0x3C, 1, { 0x00 }, false },                   // Border waveform for grayscale
+        { 0x4E, 1, { 0x00 }, false },                   // RAM X counter
+        { 0x4F, 2, { 0xC7, 0x00 }, false }              // RAM Y counter 199
+    };
+    static constexpr size_t INIT_SEQUENCE_GRAY_LENGTH = sizeof(INIT_SEQUENCE_GRAY) / sizeof(INIT_SEQUENCE_GRAY[0]);
+
+    // ===== DEBUGGING & DIAGNOSTICS =====
+    
+    /**
+     * @brief Enable or disable debug output
+     * @param enable true to enable debug messages, false to disable
+     */
+    void setDebugMode(bool enable) { debug_enabled_ = enable; }
+    
+    /**
+     * @brief Get last error message
+     * @return String describing the last error that occurred
+     */
+    const char* getLastError() { return last_error_; }
+    
+    // ===== SHADOW FRAMEBUFFER =====
+    
+    static constexpr unsigned int PLANE_NEW = 0;  ///< Shadow of RAM 0x24 (black/white, "new")
+    static constexpr unsigned int PLANE_OLD = 1;  ///< Shadow of RAM 0x26 (red, "old")
+    
+    /**
+     * @brief Mirror both controller RAM planes in a 2 x 5000 byte shadow
+     * Every command and RAM write sent by the driver is tracked, so the shadow
+     * always matches controller RAM once both planes have been fully written.
+     * @param storage 10000-byte buffer to use, or nullptr to allocate one
+     * @return true if the shadow is active, false if allocation failed
+     * @note Enable before initializeMonochrome()/initialize4Grayscale()
+     */
+    bool enableShadowBuffer(unsigned char* storage = nullptr);
+    
+    /**
+     * @brief Stop tracking and release an allocated shadow buffer
+     */
+    void disableShadowBuffer();
+    
+    /**
+     * @brief Get one shadow plane in frame order (row 0 = top of panel, 25 bytes per row)
+     * @param plane PLANE_NEW or PLANE_OLD
+     * @return 5000-byte plane, or nullptr if the shadow is disabled
+     */
+    const unsigned char* getShadowPlane(unsigned int plane) const;
+    
+    /**
+     * @brief Check if a shadow plane reflects controller RAM
+     * @param plane PLANE_NEW or PLANE_OLD
+     * @return true once the plane was fully written while tracked
+     */
+    bool isShadowPlaneValid(unsigned int plane) const;
+    
+    /**
+     * @brief Split 2bpp 4-gray data into both RAM plane images in one pass
+     * Table-driven: each source byte is looked up once and contributes a nibble
+     * to each plane. Output is inverted, ready for RAM 0x24 / 0x26.
+     * @param gray Source, 2 * plane_bytes bytes (RAM or PROGMEM)
+     * @param plane_new Output for RAM 0x24 (plane_bytes bytes)
+     * @param plane_old Output for RAM 0x26 (plane_bytes bytes)
+     * @param plane_bytes Number of bytes per output plane
+     */
+    static void splitGray4(const unsigned char* gray, unsigned char* plane_new,
+                           unsigned char* plane_old, size_t plane_bytes);
+    
+    /**
+     * @brief Find the byte-aligned rectangles where two 1bpp frames differ
+     * Frames are compared 32 bits at a time; differing bytes are grouped into
+     * connected areas and their bounding boxes merged until none overlap.
+     * @param old_frame 5000-byte frame (e.g. the shadow of what is on the panel)
+     * @param new_frame 5000-byte frame to compare against
+     * @param rects Output array
+     * @param max_rects Capacity of rects; closest rectangles are merged to fit
+     * @return Number of rectangles written (0 = frames are identical)
+     */
+    static unsigned int findDirtyRects(const unsigned char* old_frame, const unsigned char* new_frame,
+                                       FrameRect* rects, unsigned int max_rects);
+    
+    /**
+     * @brief Add a rectangle to a dirty set, keeping the set free of touching rectangles
+     * Rectangles the new one overlaps or touches are replaced by their union; when
+     * the set is full the cheapest pair is merged to make room.
+     * @param rects Dirty set (capacity max_rects)
+     * @param count Rectangles currently in the set
+     * @param max_rects Capacity of rects
+     * @param rect Rectangle to add
+     * @return New number of rectangles
+     */
+    static unsigned int addDirtyRect(FrameRect* rects, unsigned int count, unsigned int max_rects,
+                                     const FrameRect& rect);
+    
+    /**
+     * @brief Group rectangles into RAM windows so the estimated transfer time is minimal
+     * Greedily merges the pair with the largest saving while the window setup of a
+     * separate window costs more than the extra bytes of the merged bounding box.
+     * @param rects Input rectangles
+     * @param count Number of rectangles
+     * @param model Transfer cost estimate
+     * @param windows Output windows (capacity count)
+     * @param assignment Output: window index for every input rectangle
+     * @return Number of windows
+     */
+    static unsigned int planWindows(const FrameRect* rects, unsigned int count, const TransferCostModel& model,
+                                    FrameRect* windows, unsigned char* assignment);
+    
+    /**
+     * @brief Estimated time to upload one RAM window
+     * @param rect Window
+     * @param model Transfer cost estimate
+     * @return Microseconds for window setup, RAM command and data
+     */
+    static float windowCost(const FrameRect& rect, const TransferCostModel& model);
+    
+    /**
+     * @brief Set the transfer cost estimate used by updateRegions()
+     */
+    void setCostModel(const TransferCostModel& model) { cost_model_ = model; }
+    
+    /**
+     * @brief Get the transfer cost estimate used by updateRegions()
+     */
+    const TransferCostModel& getCostModel() const { return cost_model_; }
+    
+    /**
+     * @brief Check if a partial refresh session is active
+     * @return true between beginPartialSession() and endPartialSession()
+     */
+    bool isPartialSessionActive() const { return partial_session_; }
+    
+    /**
+     * @brief Select the waveform of partial refreshes
+     * PARTIAL_WAVEFORM_FAST loads LUT_DATA_PartialFast with its own VGH/VSH/VSL/VCOM;
+     * the LUT stays loaded until a reset or an update that reloads the OTP LUT, so
+     * inside a partial session it is sent only once. Schedule a full refresh more
+     * often than with the OTP waveform to clear ghosting.
+     */
+    void setPartialWaveform(PartialWaveform waveform) { partial_waveform_ = waveform; }
+    
+    /**
+     * @brief Get the waveform of partial refreshes
+     */
+    PartialWaveform getPartialWaveform() const { return partial_waveform_; }
+    
+    /**
+     * @brief Select the asset pack used by displayAsset()
+     * @param pack Opened pack (not owned; must outlive its use), nullptr to detach
+     */
+    void setAssetPack(const GDEH0154D67_AssetPack* pack) { asset_pack_ = pack; }
+
+protected:
+    GDEH0154D67_Base()
+        : initialized_(false), debug_enabled_(false), last_error_("No error"),
+          controller_mode_(MODE_OFF), partial_session_(false), loaded_lut_(LUT_NONE),
+          partial_waveform_(PARTIAL_WAVEFORM_OTP), config_{{0}, 0}, asset_pack_(nullptr),
+          shadow_(nullptr), shadow_owned_(false), shadow_valid_{false, false} {}
+    
+    ~GDEH0154D67_Base() { disableShadowBuffer(); }
+
+    // ===== HARDWARE CONSTANTS =====
+    static constexpr unsigned int DISPLAY_WIDTH = 200;    ///< Display width in pixels
+    static constexpr unsigned int DISPLAY_HEIGHT = 200;   ///< Display height in pixels  
+    static constexpr unsigned int MONO_BUFFER_SIZE = 5000; ///< Monochrome buffer size
+    static constexpr unsigned int GRAY_BUFFER_SIZE = 10000; ///< 4-grayscale buffer size
+    static constexpr unsigned int MAX_LINE_BYTES = 25;    ///< Bytes per line (200/8)
+    static constexpr unsigned int MAX_COLUMN_BYTES = 200; ///< Bytes per column
+    static constexpr unsigned int GRAY_CHUNK_SIZE = 250;  ///< RAM bytes converted per 4-gray upload chunk
+    static constexpr unsigned int FRAME_CHUNK_SIZE = 250; ///< Bytes gathered per frame-rectangle upload chunk
+    static constexpr unsigned int DECODE_CHUNK_SIZE = 64; ///< Bytes decoded per compressed-image upload chunk
+    static constexpr unsigned int MAX_DIRTY_RECTS = 16;   ///< Rectangles per updateFromFrame() call
+    static constexpr unsigned int MAX_PLANNED_REGIONS = 16; ///< Regions per updateRegions() call considered for merging
+    static constexpr unsigned int WINDOW_TRANSACTIONS = 15; ///< CS transactions per window: 0x44/0x45/0x4E/0x4F + args, RAM command, data
+    static constexpr unsigned int WINDOW_SETUP_BYTES = 14;  ///< Command and argument bytes per window
+    static constexpr unsigned int CALIBRATION_BYTES = 1000; ///< Bytes streamed by calibrateCostModel()
+    static constexpr unsigned int DELTA_HEADER_SIZE = 6;    ///< 'BMD', record count, payload length
+    static constexpr unsigned int DELTA_RECORD_HEADER_SIZE = 4; ///< x_start_byte, x_end_byte, row_start, row_end
+    static constexpr unsigned char PATTERN_FILL_WHITE = 0xF7; ///< 0x46/0x47 argument: one 200x200 step, value 1
+    static constexpr unsigned char PATTERN_FILL_BLACK = 0x77; ///< 0x46/0x47 argument: one 200x200 step, value 0
+    static constexpr unsigned char FAST_REFRESH_TEMPERATURE = 0x64; ///< 100 degC forced into 0x1A for the fast waveform
+
+    static const unsigned char LUT_DATA_4Gray[159]; ///< 4-grayscale waveform + voltages
+    static const unsigned char LUT_DATA_PartialFast[159]; ///< Short mono partial waveform + voltages
+    static const unsigned char GRAY_SPLIT_TABLE[256]; ///< 2bpp byte -> RAM1 nibble (high) | RAM2 nibble (low)
+
+    // ===== STATE VARIABLES =====
+    bool initialized_;     ///< Whether display has been initialized
+    bool debug_enabled_;   ///< Whether debug output is enabled
+    const char* last_error_; ///< Last error message
+    
+    /**
+     * @brief Register setup the controller currently holds
+     */
+    enum ControllerMode {
+        MODE_OFF,       ///< Power-on defaults (after reset) or deep sleep
+        MODE_MONO,      ///< initializeMonochrome() sequence applied
+        MODE_GRAY,      ///< initialize4Grayscale() sequence applied
+        MODE_PARTIAL    ///< Reset + partial border setup for region updates
+    };
+    ControllerMode controller_mode_; ///< Tracked controller state
+    bool partial_session_;           ///< Keep MODE_PARTIAL across region updates
+    
+    /**
+     * @brief Waveform the LUT register (0x32) currently holds
+     */
+    enum LoadedLut {
+        LUT_NONE,           ///< Power-on defaults (after reset) or deep sleep
+        LUT_OTP,            ///< Loaded from OTP by an update with 0x22 bit 4
+        LUT_GRAY,           ///< LUT_DATA_4Gray
+        LUT_PARTIAL_FAST    ///< LUT_DATA_PartialFast
+    };
+    LoadedLut loaded_lut_;           ///< Tracked LUT register content
+    PartialWaveform partial_waveform_; ///< Waveform of refreshPartial()
+    
+    /**
+     * @brief Configuration registers that differ between the controller modes
+     */
+    enum ConfigRegister {
+        CONFIG_DRIVER_OUTPUT,   ///< 0x01 (first argument; the other two are 0x00)
+        CONFIG_ENTRY_MODE,      ///< 0x11
+        CONFIG_BORDER,          ///< 0x3C
+        CONFIG_TEMP_SENSOR,     ///< 0x18
+        CONFIG_ANALOG_BLOCK,    ///< 0x74
+        CONFIG_DIGITAL_BLOCK,   ///< 0x7E
+        CONFIG_REGISTER_COUNT
+    };
+    
+    /**
+     * @brief Values of the configuration registers
+     */
+    struct ControllerConfig {
+        unsigned char value[CONFIG_REGISTER_COUNT]; ///< Register argument
+        unsigned char known;                        ///< Bit per register: value is set (tracked) or required (target)
+    };
+    
+    static const unsigned char CONFIG_COMMANDS[CONFIG_REGISTER_COUNT]; ///< Command byte per ConfigRegister
+    static const ControllerConfig MODE_CONFIGS[4]; ///< Per ControllerMode; MODE_OFF holds the reset defaults
+    
+    ControllerConfig config_;        ///< What the registers currently hold
+    
+    TransferCostModel cost_model_;   ///< Estimate used to plan region windows
+    const GDEH0154D67_AssetPack* asset_pack_; ///< Pack for displayAsset() (not owned)
+    
+    // ===== SHADOW STATE =====
+    static constexpr unsigned int SHADOW_BUFFER_SIZE = 2 * MONO_BUFFER_SIZE; ///< Both RAM planes
+    
+    unsigned char* shadow_;          ///< PLANE_NEW then PLANE_OLD, frame order (nullptr = disabled)
+    bool shadow_owned_;              ///< shadow_ was allocated by enableShadowBuffer()
+    bool shadow_valid_[2];           ///< Plane content is known
+    
+    /**
+     * @brief Controller RAM addressing as last programmed, mirrored for the shadow
+     */
+    struct RamCursor {
+        bool known;                  ///< Registers are known (after a tracked reset)
+        unsigned char entry_mode;    ///< Data entry mode (0x11)
+        unsigned int x_start, x_end; ///< RAM X window in bytes (0x44)
+        unsigned int y_start, y_end; ///< RAM Y window (0x45)
+        unsigned int x, y;           ///< Address counters (0x4E/0x4F)
+    };
+    RamCursor cursor_;               ///< Tracked RAM addressing
+    unsigned char track_command_;    ///< Last command seen by the tracker
+    unsigned char track_args_[4];    ///< Arguments of track_command_ so far
+    unsigned int track_arg_count_;   ///< Number of bytes in track_args_
+    bool track_full_write_;          ///< Current RAM write started at the full-screen origin
+    unsigned int track_written_;     ///< Bytes written by the current RAM write
+
+    // ===== 4-GRAYSCALE PROCESSING =====
+    // Per-pixel reference converters; the driver uses splitGray4()
+    
+    /**
+     * @brief Convert 2 grayscale bytes to 1 RAM1 byte
+     * @param data1 First grayscale byte
+     * @param data2 Second grayscale byte
+     * @return Processed byte for RAM1
+     */
+    static unsigned char convertGray2ToRam1(unsigned char data1, unsigned char data2);
+    
+    /**
+     * @brief Convert 2 grayscale bytes to 1 RAM2 byte  
+     * @param data1 First grayscale byte
+     * @param data2 Second grayscale byte
+     * @return Processed byte for RAM2
+     */
+    static unsigned char convertGray2ToRam2(unsigned char data1, unsigned char data2);
+
+    /**
+     * @brief Compare two 1bpp frames inside a rectangle
+     * @return true if all bytes inside rect are equal
+     */
+    static bool rectsEqual(const unsigned char* frame_a, const unsigned char* frame_b, const FrameRect& rect);
+    
+    /**
+     * @brief Check a frame delta header and that its records stay on the panel
+     * @param delta Delta from generated/face_deltas.h (RAM or PROGMEM)
+     * @return true if every record is in bounds and the records fill the payload exactly
+     */
+    static bool validateFrameDelta(const unsigned char* delta);
+    
+    /**
+     * @brief Read one delta record header
+     * @param record Record start (first record is at delta + DELTA_HEADER_SIZE)
+     * @param rect Output rectangle
+     * @return Pointer to the record's XOR bytes; the next record follows after rect.byteCount() bytes
+     */
+    static const unsigned char* readDeltaRecord(const unsigned char* record, FrameRect& rect);
+
+    // ===== CONTROLLER CONFIGURATION =====
+    
+    /**
+     * @brief Record that the registers required by a mode were written
+     * @param mode Mode whose MODE_CONFIGS entry is merged into config_
+     */
+    void trackControllerConfig(ControllerMode mode);
+
+    // ===== SHADOW TRACKING =====
+    
+    /**
+     * @brief Controller registers returned to power-on defaults (RST pulse or SWRESET)
+     */
+    void shadowTrackReset();
+    
+    /**
+     * @brief Track a command byte sent to the controller
+     * @param cmd Command byte
+     */
+    void shadowTrackCommand(unsigned char cmd);
+    
+    /**
+     * @brief Track data bytes sent to the controller
+     * @param data Pointer to data in RAM or flash-mapped PROGMEM
+     * @param length Number of bytes
+     */
+    void shadowTrackData(const unsigned char* data, size_t length);
+    
+    /**
+     * @brief Apply an auto pattern fill (0x46/0x47) to a shadow plane
+     * @param plane PLANE_NEW for 0x47, PLANE_OLD for 0x46
+     * @param pattern Command argument (step sizes and first-step value)
+     */
+    void shadowTrackPatternFill(unsigned int plane, unsigned char pattern);
+
+    // ===== DEBUG HELPERS =====
+    
+    /**
+     * @brief Print debug message if debug mode enabled
+     * @param message Message to print
+     */
+    void debugPrint(const char* message);
+    
+    /**
+     * @brief Set last error message
+     * @param error Error message to store
+     */
+    void setError(const char* error);
+};
+
 /**
  * @brief Main display controller class for GDEH0154D67 E-Paper Display
  * 
  * This class encapsulates all functionality needed to control the 1.54" e-paper display,
  * including initialization, data transfer, refresh modes, and power management.
+ * 
+ * @tparam Bus Bus/pin policy from GDEH0154D67_Bus.h, e.g.
+ *         GDEH0154D67<BitBangBus<5, 4, 2, 15, 18, 23>> or GDEH0154D67<SimBus>
  */
-class GDEH0154D67_Display {
+template <class Bus>
+class GDEH0154D67 : public GDEH0154D67_Base {
 public:
     // ===== CONSTRUCTOR & DESTRUCTOR =====
     
     /**
      * @brief Construct a new display controller
-     * @param busy_pin GPIO pin connected to BUSY signal (input)
-     * @param rst_pin GPIO pin connected to RST/Reset signal (output) 
-     * @param dc_pin GPIO pin connected to D/C (Data/Command) signal (output)
-     * @param cs_pin GPIO pin connected to CS (Chip Select) signal (output)
-     * @param sck_pin GPIO pin connected to SCK (SPI Clock) signal (output)
-     * @param sdi_pin GPIO pin connected to SDI (SPI Data) signal (output)
+     * @note Pin assignments are part of the Bus type
      */
-    GDEH0154D67_Display(int busy_pin = 5, int rst_pin = 4, int dc_pin = 2, 
-                       int cs_pin = 15, int sck_pin = 18, int sdi_pin = 23);
+    GDEH0154D67();
     
     /**
      * @brief Destructor - ensures display is properly put to sleep
      */
-    ~GDEH0154D67_Display();
+    ~GDEH0154D67();
 
     // ===== INITIALIZATION & SETUP =====
     
     /**
      * @brief Initialize GPIO pins for display communication
      * Must be called in setup() before any display operations
+     * @param use_hardware_spi If true, drive SCK/SDI from the VSPI/HSPI peripheral
+     *        with DMA for RAM uploads; falls back to bit-banged SPI when the pins
+     *        cannot be routed to the SPI peripheral
      */
-    void initializePins();
+    void initializePins(bool use_hardware_spi = true);
     
     /**
      * @brief Initialize display for monochrome (black/white) mode
@@ -105,6 +693,18 @@ public:
      * @return true if initialization successful, false otherwise
      */
     bool initialize4Grayscale();
+    
+    /**
+     * @brief Bring the controller into a mode with as few commands as possible
+     * An initialized controller keeps its registers: only the configuration
+     * registers that differ from the target, the 4-gray LUT if it is not
+     * loaded and the full-screen RAM window are sent (no reset, no boot wait).
+     * Falls back to initializeMonochrome()/initialize4Grayscale() when the
+     * display is not initialized, e.g. after deep sleep.
+     * @param mode Target configuration
+     * @return true if the controller is in the requested mode
+     */
+    bool switchMode(DisplayMode mode);
 
     // ===== FULL SCREEN OPERATIONS =====
     
@@ -124,20 +724,109 @@ public:
      */
     void displayFullScreen4Gray(const unsigned char* image_data, bool refresh_immediately = true);
     
+    /**
+     * @brief Display a full screen 4-grayscale image from pre-split planes
+     * @param image Plane pair, e.g. gray_planes_smile from generated/gray_planes.h
+     * @param refresh_immediately If true, triggers display refresh after loading data
+     * @note No conversion: both planes are streamed to RAM as stored
+     */
+    void displayGrayPlanes(const GrayPlaneImage& image, bool refresh_immediately = true);
+    
+    /**
+     * @brief Display a full screen image from a compressed container
+     * Decodes in DECODE_CHUNK_SIZE pieces straight into the RAM write; only the
+     * decoder window and one chunk are held in RAM.
+     * @param asset Container from generated/compressed_assets.h (RAM or PROGMEM)
+     * @param refresh_immediately If true, refreshes with the mode matching the
+     *        container (full refresh for mono, 4-gray refresh for gray planes)
+     * @return true on success, false if the container is invalid or corrupt
+     */
+    bool displayCompressedImage(const unsigned char* asset, bool refresh_immediately = true);
+    
+    /**
+     * @brief Partial update that XORs a sparse frame delta onto what the panel shows
+     * Only the delta's rectangles are uploaded, so the transfer scales with how
+     * much of the face changes. The shadow's new plane is the reference frame.
+     * @param delta Delta from generated/face_deltas.h (RAM or PROGMEM)
+     * @return true on success, false if the shadow is unavailable or the delta is invalid
+     * @note Requires enableShadowBuffer() and a known panel image, e.g. from
+     *       displayCompressedImage(asset_face_smile) or updateFromFrame()
+     */
+    bool applyFrameDelta(const unsigned char* delta);
+    
+    /**
+     * @brief Show an asset from the pack selected with setAssetPack()
+     * Dispatches on the entry kind: raw mono frames and compressed images use
+     * the full-screen paths, raw gray planes displayGrayPlanes(), deltas
+     * applyFrameDelta(). Data is read in place from the mapped pack.
+     * @param id Asset ID from generated/asset_ids.h
+     * @param refresh_immediately Refresh after loading (ignored for deltas, which always refresh)
+     * @return true on success, false if no pack is set, the ID is unknown or the asset is invalid
+     */
+    bool displayAsset(unsigned int id, bool refresh_immediately = true);
+    
+    /**
+     * @brief Partial update of one compile-time face region
+     * The RAM window is sent from the region's precomputed command bytes.
+     * @param region Descriptor from generated/bmo_face_regions.h
+     * @param image_data region.byteCount() bytes, bottom row first (like PartialRegion data)
+     * @return true on success, false if not initialized or image_data is null
+     */
+    bool updateFaceRegion(const FaceRegion& region, const unsigned char* image_data);
+    
+    /**
+     * @brief Upload several face region patches with a single partial refresh
+     * Patches covering a whole region use its precomputed window bytes.
+     * @param patches Patches to upload; rects must lie inside their regions and not overlap
+     * @param count Number of patches (0 = nothing to do)
+     * @return true on success, false if any patch is invalid (nothing is sent then)
+     */
+    bool updateFaceRegions(const FaceRegionPatch* patches, size_t count);
+    
+    /**
+     * @brief Fill a rectangle with white or black using one partial refresh
+     * Both RAM planes are filled by the controller's auto pattern fill
+     * (0x47/0x46) inside the rectangle's window; no pixel data is sent.
+     * @param rect Frame rectangle (byte columns, rows)
+     * @param white true for white, false for black
+     * @return true on success, false if the rectangle is outside the display
+     */
+    bool fillRect(const FrameRect& rect, bool white);
+    
     /**
      * @brief Fill entire screen with white color
-     * Useful for clearing the display or resetting image retention
+     * Useful for clearing the display or resetting image retention.
+     * Both RAM planes are set by the controller's auto pattern fill.
+     * @param mode Waveform selection, see refreshFull()
      */
-    void clearScreen();
+    void clearScreen(FullRefreshMode mode = FULL_REFRESH_NORMAL);
 
     // ===== PARTIAL REFRESH OPERATIONS =====
     
     /**
      * @brief Set the base image for partial refresh operations
      * @param base_image Pointer to 5000-byte base image that will remain static
+     * @param mode Waveform of the full refresh, see refreshFull()
      * @note This image serves as background for all subsequent partial updates
      */
-    void setPartialRefreshBase(const unsigned char* base_image);
+    void setPartialRefreshBase(const unsigned char* base_image, FullRefreshMode mode = FULL_REFRESH_NORMAL);
+    
+    /**
+     * @brief Enter partial refresh session mode
+     * Resets the controller and sets the partial border once; subsequent region
+     * updates only send window, pointer and RAM writes. Re-initializing the display
+     * or switchMode() keeps the session - the next update rewrites only the
+     * registers that differ from the partial setup, without a reset.
+     * @return true if the session started, false if display not initialized
+     * @note Call after setPartialRefreshBase(); ideal for blinking and talking animations
+     */
+    bool beginPartialSession();
+    
+    /**
+     * @brief Leave partial refresh session mode
+     * Region updates go back to a hardware reset + border setup per call
+     */
+    void endPartialSession();
     
     /**
      * @brief Update a rectangular region of the display (single region)
@@ -159,18 +848,74 @@ public:
      * @note This is optimized for applications like digital clocks with multiple digits
      */
     bool updateMultipleRegions(const PartialRegion regions[5]);
+    
+    /**
+     * @brief Update any number of regions with one partial refresh
+     * With a valid shadow buffer, nearby regions are merged into one RAM window
+     * whenever the cost model says the window setup costs more than the extra
+     * bytes; gaps inside a merged window are filled from the shadow.
+     * @param regions Region definitions (invalid regions are skipped)
+     * @param count Number of entries in regions
+     * @return true if all valid regions updated successfully
+     * @note Regions are drawn in array order, later ones over earlier ones. Merging
+     *       considers up to MAX_PLANNED_REGIONS leading regions, up to the first one
+     *       that overlaps an earlier region; the rest keep their own windows.
+     */
+    bool updateRegions(const PartialRegion* regions, size_t count);
+    
+    /**
+     * @brief Measure SPI throughput and per-transaction overhead for the window planner
+     * Bytes are clocked out with CS released, so the controller ignores them.
+     * @return The new cost model (unchanged if the bus cannot measure time)
+     */
+    const TransferCostModel& calibrateCostModel();
+
+    /**
+     * @brief Show a full 1bpp frame, uploading only what changed
+     * Diffs the frame against the shadow of RAM 0x24, writes the dirty
+     * byte-aligned rectangles and triggers one partial refresh.
+     * @param frame 5000-byte frame (same layout as displayFullScreenMono())
+     * @return true if the panel shows the frame, false on error
+     * @note Requires enableShadowBuffer(); if the shadow is not yet valid the
+     *       whole frame is written once. No refresh happens if nothing changed.
+     */
+    bool updateFromFrame(const unsigned char* frame);
+
+    /**
+     * @brief Write rectangles of a frame and start a partial refresh without waiting
+     * Same RAM traffic as updateFromFrame() up to the refresh; call syncOldPlane()
+     * with the same rectangles once the refresh has completed.
+     * @param frame 5000-byte frame to take the rectangles from
+     * @param rects Rectangles to write (inside the frame)
+     * @param count Number of rectangles (1 or more)
+     * @return Handle of the started refresh, invalid on error
+     * @note Requires enableShadowBuffer() with a valid shadow of the shown frame
+     */
+    RefreshHandle updateFrameRectsAsync(const unsigned char* frame, const FrameRect* rects, size_t count);
+    
+    /**
+     * @brief Copy the shown frame into RAM 0x26 over the given rectangles
+     * Finishes updateFrameRectsAsync() so the next differential update starts
+     * from what the panel shows. Waits for a running refresh first.
+     * @param rects Rectangles passed to updateFrameRectsAsync()
+     * @param count Number of rectangles
+     */
+    void syncOldPlane(const FrameRect* rects, size_t count);
 
     // ===== DISPLAY REFRESH & UPDATE =====
     
     /**
      * @brief Trigger full screen refresh (with flicker)
      * Use this for complete image changes or to clear ghosting every 5-10 partial updates
+     * @param mode FULL_REFRESH_FAST forces a high temperature into 0x1A and loads
+     *             its shorter OTP waveform before the update (0x22 = 0x91, then 0xC7)
      */
-    void refreshFull();
+    void refreshFull(FullRefreshMode mode = FULL_REFRESH_NORMAL);
     
     /**
      * @brief Trigger partial refresh (no flicker)  
      * Use this for fast updates of small regions
+     * Uses the waveform selected with setPartialWaveform()
      */
     void refreshPartial();
     
@@ -180,6 +925,53 @@ public:
      */
     void refresh4Grayscale();
 
+    // ===== ASYNCHRONOUS REFRESH =====
+    
+    /**
+     * @brief Start a full screen refresh and return immediately
+     * @param callback Optional function called once the refresh has finished
+     * @param context User pointer passed to the callback
+     * @param mode Waveform selection, see refreshFull()
+     * @return Handle for isRefreshComplete() / waitRefresh()
+     * @note The next display operation waits for the refresh to finish first
+     */
+    RefreshHandle refreshFullAsync(RefreshCallback callback = nullptr, void* context = nullptr,
+                                   FullRefreshMode mode = FULL_REFRESH_NORMAL);
+    
+    /**
+     * @brief Start a partial refresh and return immediately
+     * @see refreshFullAsync()
+     */
+    RefreshHandle refreshPartialAsync(RefreshCallback callback = nullptr, void* context = nullptr);
+    
+    /**
+     * @brief Start a 4-grayscale refresh and return immediately
+     * @see refreshFullAsync()
+     */
+    RefreshHandle refresh4GrayscaleAsync(RefreshCallback callback = nullptr, void* context = nullptr);
+    
+    /**
+     * @brief Check if an asynchronous refresh has finished (non-blocking)
+     * @param handle Handle returned by one of the async refresh calls
+     * @return true if the refresh is done; its callback has been run
+     */
+    bool isRefreshComplete(RefreshHandle handle);
+    
+    /**
+     * @brief Sleep until an asynchronous refresh has finished
+     * @param handle Handle returned by one of the async refresh calls
+     * @param timeout_ms Maximum time to wait in milliseconds (0 = infinite)
+     * @return true if the refresh is done, false on timeout
+     */
+    bool waitRefresh(RefreshHandle handle, unsigned long timeout_ms = 0);
+    
+    /**
+     * @brief Dispatch the completion callback if the running refresh has finished
+     * Call regularly (e.g. from loop()) when using callbacks
+     * @return true while a refresh is still running
+     */
+    bool poll();
+
     // ===== POWER MANAGEMENT =====
     
     /**
@@ -197,80 +989,81 @@ public:
     
     /**
      * @brief Wait for display to finish current operation
+     * The calling task sleeps until the BUSY falling-edge interrupt fires
      * @param timeout_ms Maximum time to wait in milliseconds (0 = infinite)
      * @return true if display became ready, false if timeout occurred
      */
     bool waitForReady(unsigned long timeout_ms = 0);
 
-    // ===== UTILITY FUNCTIONS =====
+    // ===== BURST DATA TRANSFER =====
     
     /**
-     * @brief Get display width in pixels
-     * @return Display width (200 pixels)
+     * @brief Send a block of data bytes with CS held low for the whole payload
+     * @param data Pointer to data in RAM or flash-mapped PROGMEM
+     * @param length Number of bytes to send
+     * @note Send the target command (e.g. 0x24/0x26/0x32) with its own call first;
+     *       DC is set once and never toggled during the block
      */
-    static constexpr unsigned int getWidth() { return DISPLAY_WIDTH; }
+    void writeDataBlock(const unsigned char* data, size_t length);
     
     /**
-     * @brief Get display height in pixels  
-     * @return Display height (200 pixels)
+     * @brief Start a streamed data payload (CS low, DC = data)
+     * Use with streamData() when the payload is generated on the fly
      */
-    static constexpr unsigned int getHeight() { return DISPLAY_HEIGHT; }
+    void beginDataStream();
     
     /**
-     * @brief Get full screen buffer size in bytes
-     * @return Buffer size for monochrome mode (5000 bytes)
+     * @brief Append one byte to the current data stream
+     * @param data Byte to send
      */
-    static constexpr unsigned int getMonoBufferSize() { return MONO_BUFFER_SIZE; }
+    void streamData(unsigned char data);
     
     /**
-     * @brief Get 4-grayscale buffer size in bytes
-     * @return Buffer size for 4-gray mode (10000 bytes)  
+     * @brief Append a block to the current data stream
+     * @param data Pointer to data in RAM or flash-mapped PROGMEM
+     * @param length Number of bytes to send
      */
-    static constexpr unsigned int getGrayBufferSize() { return GRAY_BUFFER_SIZE; }
-
-    // ===== DEBUGGING & DIAGNOSTICS =====
+    void streamData(const unsigned char* data, size_t length);
     
     /**
-     * @brief Enable or disable debug output
-     * @param enable true to enable debug messages, false to disable
+     * @brief Finish the current data stream and release CS
      */
-    void setDebugMode(bool enable) { debug_enabled_ = enable; }
+    void endDataStream();
+
+    /**
+     * @brief Access the bus policy instance (e.g. to attach a simulated panel)
+     */
+    Bus& bus() { return bus_; }
     
     /**
-     * @brief Get last error message
-     * @return String describing the last error that occurred
+     * @brief Check which SPI transport is in use
+     * @return true if hardware SPI/DMA is active, false if bit-banged SPI is used
      */
-    const char* getLastError() { return last_error_; }
+    bool isHardwareSpiActive() const { return bus_.isHardwareSpi(); }
 
 private:
-    // ===== HARDWARE CONSTANTS =====
-    static constexpr unsigned int DISPLAY_WIDTH = 200;    ///< Display width in pixels
-    static constexpr unsigned int DISPLAY_HEIGHT = 200;   ///< Display height in pixels  
-    static constexpr unsigned int MONO_BUFFER_SIZE = 5000; ///< Monochrome buffer size
-    static constexpr unsigned int GRAY_BUFFER_SIZE = 10000; ///< 4-grayscale buffer size
-    static constexpr unsigned int MAX_LINE_BYTES = 25;    ///< Bytes per line (200/8)
-    static constexpr unsigned int MAX_COLUMN_BYTES = 200; ///< Bytes per column
-
-    // ===== GPIO PIN ASSIGNMENTS =====
-    int busy_pin_;  ///< BUSY signal pin (input)
-    int rst_pin_;   ///< Reset signal pin (output)
-    int dc_pin_;    ///< Data/Command signal pin (output) 
-    int cs_pin_;    ///< Chip select signal pin (output)
-    int sck_pin_;   ///< SPI clock signal pin (output)
-    int sdi_pin_;   ///< SPI data signal pin (output)
-
-    // ===== STATE VARIABLES =====
-    bool initialized_;     ///< Whether display has been initialized
-    bool debug_enabled_;   ///< Whether debug output is enabled
-    const char* last_error_; ///< Last error message
-
-    // ===== LOW-LEVEL SPI COMMUNICATION =====
+    Bus bus_;  ///< Bus/pin policy instance
+    
+    // ===== ASYNC REFRESH STATE =====
+    bool refresh_pending_;             ///< A refresh was started and not yet completed
+    unsigned long refresh_id_;         ///< Sequence number of the latest refresh
+    RefreshCallback refresh_callback_; ///< Callback for the pending refresh
+    void* refresh_context_;            ///< User pointer for refresh_callback_
+    
+    /**
+     * @brief Send Display Update Control 2 + Master Activation without waiting
+     * @param update_mode Value for command 0x22
+     */
+    RefreshHandle startRefresh(unsigned char update_mode, RefreshCallback callback, void* context);
     
     /**
-     * @brief Write a single byte via bit-banged SPI
-     * @param value Byte to transmit
+     * @brief Wait for the pending refresh and run its callback
+     * @param timeout_ms Maximum time to wait in milliseconds (0 = infinite)
+     * @return true if no refresh is pending any more
      */
-    void spiWrite(unsigned char value);
+    bool finishRefresh(unsigned long timeout_ms);
+
+    // ===== LOW-LEVEL SPI COMMUNICATION =====
     
     /**
      * @brief Send command to display
@@ -286,125 +1079,191 @@ private:
     
     /**
      * @brief Wait for display BUSY signal to go low
-     * Blocks until display is ready for next operation
+     * Blocks until display is ready for next operation (sleeps on the BUSY interrupt)
      */
     void waitBusy();
 
-    // ===== TIMING & DELAY FUNCTIONS =====
+    /**
+     * @brief Program RAM window and address counters (0x44, 0x45, 0x4E, 0x4F)
+     * @param x_start_byte First RAM X byte
+     * @param x_end_byte Last RAM X byte
+     * @param y_start First RAM Y address (counter start)
+     * @param y_end Last RAM Y address
+     */
+    void setRamWindow(unsigned int x_start_byte, unsigned int x_end_byte,
+                      unsigned int y_start, unsigned int y_end);
     
     /**
-     * @brief Microsecond delay
-     * @param microseconds Delay time in microseconds
+     * @brief Frame rectangle covered by a region (legacy PartialRegion addressing)
+     * Rows that fall past RAM row 199 are clipped off, as the controller drops them.
+     * @param region Region to convert
+     * @param rect Output rectangle
+     * @return false if the first row of the region lies outside RAM rows 0-199
      */
-    void delayMicroseconds(unsigned int microseconds);
+    static bool regionFrameRect(const PartialRegion& region, FrameRect& rect);
     
     /**
-     * @brief Millisecond delay
-     * @param milliseconds Delay time in milliseconds  
+     * @brief Write one region to a RAM plane using its own window
+     * @param ram_command 0x24 or 0x26
+     * @param region Region to write
      */
-    void delayMilliseconds(unsigned long milliseconds);
+    void writeRegion(unsigned char ram_command, const PartialRegion& region);
     
     /**
-     * @brief SPI timing delay
-     * @param rate Delay rate (higher = longer delay)
+     * @brief Write a merged window to RAM 0x24: shadow content overlaid with member regions
+     * @param window Merged window
+     * @param regions All regions of the update
+     * @param members Region indices in this window, in update order
+     * @param rects Frame rectangles of the members
+     * @param member_count Number of members
      */
-    void spiDelay(unsigned char rate);
-
-    // ===== 4-GRAYSCALE PROCESSING =====
+    void writeComposedWindow(const FrameRect& window, const PartialRegion* regions,
+                             const size_t* members, const FrameRect* rects, unsigned int member_count);
     
     /**
-     * @brief Convert 2 grayscale bytes to 1 RAM1 byte
-     * @param data1 First grayscale byte
-     * @param data2 Second grayscale byte
-     * @return Processed byte for RAM1
+     * @brief Decode one 5000-byte plane and stream it to a RAM write command
+     * @return false if the decoder ran out of data or failed
      */
-    unsigned char convertGray2ToRam1(unsigned char data1, unsigned char data2);
+    bool writeDecodedPlane(unsigned char ram_command, GDEH0154D67_AssetDecoder& decoder);
     
     /**
-     * @brief Convert 2 grayscale bytes to 1 RAM2 byte  
-     * @param data1 First grayscale byte
-     * @param data2 Second grayscale byte
-     * @return Processed byte for RAM2
+     * @brief Write shadow new plane XOR delta bytes into a frame rectangle
+     * @param rect Target rectangle (frame rows)
+     * @param xor_data XOR bytes in stream order (bottom row first)
+     */
+    void writeDeltaRect(const FrameRect& rect, const unsigned char* xor_data);
+    
+    /**
+     * @brief Program the RAM window and address counters from a face region's precomputed bytes
+     */
+    void setFaceRegionWindow(const FaceRegion& region);
+    
+    /**
+     * @brief Fill the current RAM window of one plane with a regular pattern
+     * @param ram_command 0x24 (filled through 0x47) or 0x26 (through 0x46)
+     * @param pattern PATTERN_FILL_WHITE, PATTERN_FILL_BLACK or another 0x46/0x47 argument
+     * @note Waits for BUSY: the controller fills RAM on its own
+     */
+    void fillRamPattern(unsigned char ram_command, unsigned char pattern);
+    
+    /**
+     * @brief Write part of a face region image to a RAM plane
+     * @param ram_command 0x24 or 0x26
+     * @param patch Region image and the rectangle of it to send
+     */
+    void writeFaceRegionPatch(unsigned char ram_command, const FaceRegionPatch& patch);
+    
+    /**
+     * @brief Write one frame rectangle to a RAM plane
+     * Rows are streamed bottom-up to match the Y-increment addressing of the partial setup
+     * @param ram_command 0x24 or 0x26
+     * @param frame 5000-byte source frame
+     * @param rect Rectangle to copy
+     */
+    void writeFrameRect(unsigned char ram_command, const unsigned char* frame, const FrameRect& rect);
+    
+    /**
+     * @brief Make RAM 0x26 match the shown frame inside a rectangle before a differential update
+     * Writes the shadow of 0x24 to 0x26 where the old plane is stale or unknown;
+     * does nothing without a valid shadow of 0x24.
+     * @param rect Rectangle about to be written to 0x24
      */
-    unsigned char convertGray2ToRam2(unsigned char data1, unsigned char data2);
+    void presyncOldPlane(const FrameRect& rect);
     
     /**
-     * @brief Load custom lookup table for 4-grayscale mode
-     * @param wave_data Pointer to 159-byte LUT data
+     * @brief Pulse RST (2 x 10ms); controller registers return to power-on defaults
      */
-    void loadGrayscaleLUT(const unsigned char* wave_data);
+    void hardwareReset();
+    
+    /**
+     * @brief Reset + partial border setup before a region update
+     * Skipped when a partial session is active and the controller is still set up;
+     * in a session a mono/gray setup is switched over without the reset
+     */
+    void preparePartialUpdate();
 
-    // ===== GPIO CONTROL MACROS =====
+    /**
+     * @brief Force FAST_REFRESH_TEMPERATURE and load its OTP waveform (no display update)
+     * The next update must not reload temperature or LUT (0x22 = 0xC7).
+     */
+    void loadFastWaveform();
     
     /**
-     * @brief Set MOSI line high
+     * @brief Load a 159-byte waveform table (LUT + EOPQ, VGH, VSH1/VSH2/VSL, VCOM) unless already active
+     * @param lut Cache tag of the table
+     * @param wave_data Table in the LUT_DATA_4Gray layout
      */
-    void setMOSI_High() { digitalWrite(sdi_pin_, HIGH); }
+    void loadCustomWaveform(LoadedLut lut, const unsigned char* wave_data);
     
     /**
-     * @brief Set MOSI line low  
+     * @brief Write the configuration registers of a mode that differ from config_
+     * @param mode Target mode; controller_mode_ is set to it
      */
-    void setMOSI_Low() { digitalWrite(sdi_pin_, LOW); }
+    void applyControllerConfig(ControllerMode mode);
     
     /**
-     * @brief Set clock line high
+     * @brief Send a precompiled command sequence
+     * CS stays low from one BUSY wait to the next; each command's arguments go
+     * out as one block. Shadow tracking sees the same stream as writeCommand().
+     * @param sequence Commands, e.g. INIT_SEQUENCE_MONO
+     * @param length Number of commands
      */
-    void setCLK_High() { digitalWrite(sck_pin_, HIGH); }
+    void runCommandSequence(const InitCommand* sequence, size_t length);
     
     /**
-     * @brief Set clock line low
+     * @brief Prepare the partial waveform and return its update sequence
+     * @return 0x22 argument for the partial refresh
      */
-    void setCLK_Low() { digitalWrite(sck_pin_, LOW); }
+    unsigned char preparePartialWaveform();
+
+    // ===== GPIO CONTROL =====
     
     /**
      * @brief Set chip select low (active)
      */
-    void setCS_Active() { digitalWrite(cs_pin_, LOW); }
+    void setCS_Active() { bus_.csActive(); }
     
     /**
      * @brief Set chip select high (inactive)
      */
-    void setCS_Inactive() { digitalWrite(cs_pin_, HIGH); }
+    void setCS_Inactive() { bus_.csInactive(); }
     
     /**
      * @brief Set data/command line for command mode
      */
-    void setDC_Command() { digitalWrite(dc_pin_, LOW); }
+    void setDC_Command() { bus_.dcCommand(); }
     
     /**
      * @brief Set data/command line for data mode
      */
-    void setDC_Data() { digitalWrite(dc_pin_, HIGH); }
+    void setDC_Data() { bus_.dcData(); }
     
     /**
      * @brief Set reset line low (active reset)
+     * A running waveform is finished first; resetting mid-refresh corrupts the panel
      */
-    void setRST_Active() { digitalWrite(rst_pin_, LOW); }
+    void setRST_Active() { finishRefresh(0); bus_.rstActive(); }
     
     /**
      * @brief Set reset line high (normal operation)
      */
-    void setRST_Inactive() { digitalWrite(rst_pin_, HIGH); }
+    void setRST_Inactive() { bus_.rstInactive(); }
     
     /**
      * @brief Read BUSY signal state
      * @return true if display is busy, false if ready
      */
-    bool readBusy() { return digitalRead(busy_pin_) == HIGH; }
-
-    // ===== DEBUG HELPERS =====
-    
-    /**
-     * @brief Print debug message if debug mode enabled
-     * @param message Message to print
-     */
-    void debugPrint(const char* message);
-    
-    /**
-     * @brief Set last error message
-     * @param error Error message to store
-     */
-    void setError(const char* error);
+    bool readBusy() { return bus_.busy(); }
 };
 
+#ifdef ARDUINO
+/**
+ * @brief Default driver for the BMO wiring: BUSY=5, RST=4, DC=2, CS=15, SCK=18, SDI=23
+ * SCK/SDI are the VSPI IO_MUX pins, so hardware SPI runs at full speed
+ */
+typedef GDEH0154D67<HwSpiBus<5, 4, 2, 15, 18, 23>> GDEH0154D67_Display;
+#endif
+
+#include "GDEH0154D67_Display_impl.h"
+
 #endif // GDEH0154D67_DISPLAY_H
@@ -0,0 +1,1462 @@
+/**
+ * @file GDEH0154D67_Display_impl.h
+ * @brief Template implementation of the GDEH0154D67 display driver
+ * 
+ * Included at the end of GDEH0154D67_Display.h; do not include directly.
+ * Bus-independent helpers (LUT data, 4-gray conversion, debug output) live in
+ * GDEH0154D67_Display.cpp so they are compiled once for all bus policies.
+ * 
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef GDEH0154D67_DISPLAY_IMPL_H
+#define GDEH0154D67_DISPLAY_IMPL_H
+
+// ===== CONSTRUCTOR & DESTRUCTOR =====
+
+template <class Bus>
+GDEH0154D67<Bus>::GDEH0154D67()
+    : refresh_pending_(false), refresh_id_(0), refresh_callback_(nullptr), refresh_context_(nullptr) {
+    debugPrint("Display controller created with pin configuration");
+}
+
+template <class Bus>
+GDEH0154D67<Bus>::~GDEH0154D67() {
+    if (initialized_) {
+        debugPrint("Destructor: Putting display to sleep");
+        enterDeepSleep();
+    }
+}
+
+// ===== INITIALIZATION & SETUP =====
+
+template <class Bus>
+void GDEH0154D67<Bus>::initializePins(bool use_hardware_spi) {
+    debugPrint("Initializing GPIO pins");
+    
+    // Configure pin directions; SCK/SDI are handed to the SPI peripheral when possible
+    if (bus_.begin(use_hardware_spi)) {
+        debugPrint("Using hardware SPI with DMA for RAM uploads");
+    } else {
+        debugPrint("Using bit-banged SPI");
+    }
+    
+    // Set initial states - CS and RST inactive (high)
+    setCS_Inactive();
+    setRST_Inactive();
+    
+    debugPrint("GPIO pins initialized successfully");
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::initializeMonochrome() {
+    debugPrint("Starting monochrome display initialization");
+    
+    // Hardware reset sequence - essential for reliable operation
+    hardwareReset();
+    
+    // Wait for display to be ready after reset
+    waitBusy();
+    
+    // Soft reset, driver output, RAM addressing, border and temperature sensor
+    runCommandSequence(INIT_SEQUENCE_MONO, INIT_SEQUENCE_MONO_LENGTH);
+    
+    initialized_ = true;
+    trackControllerConfig(MODE_MONO);
+    controller_mode_ = MODE_MONO;
+    debugPrint("Monochrome initialization completed successfully");
+    return true;
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::initialize4Grayscale() {
+    debugPrint("Starting 4-grayscale display initialization");
+    
+    // Hardware reset sequence
+    hardwareReset();
+    
+    waitBusy();
+    
+    // Soft reset, analog/digital blocks for grayscale, RAM addressing, border
+    runCommandSequence(INIT_SEQUENCE_GRAY, INIT_SEQUENCE_GRAY_LENGTH);
+    
+    // Custom lookup table and voltage levels for grayscale waveforms
+    loadCustomWaveform(LUT_GRAY, LUT_DATA_4Gray);
+    
+    waitBusy();
+    
+    initialized_ = true;
+    trackControllerConfig(MODE_GRAY);
+    controller_mode_ = MODE_GRAY;
+    debugPrint("4-grayscale initialization completed successfully");
+    return true;
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::switchMode(DisplayMode mode) {
+    ControllerMode target = mode == DISPLAY_MODE_GRAY ? MODE_GRAY : MODE_MONO;
+    
+    if (!initialized_) {
+        return mode == DISPLAY_MODE_GRAY ? initialize4Grayscale() : initializeMonochrome();
+    }
+    // A mono refresh in gray mode (0xF7, fast waveform) replaces the LUT but not
+    // the registers; the gray refresh (0xC7) loads none, so restore it first
+    if (target == MODE_GRAY) {
+        loadCustomWaveform(LUT_GRAY, LUT_DATA_4Gray);
+    }
+    if (controller_mode_ == target) {
+        return true;
+    }
+    
+    debugPrint(mode == DISPLAY_MODE_GRAY ? "Switching to 4-grayscale mode" : "Switching to monochrome mode");
+    
+    applyControllerConfig(target);
+    // Mono refreshes reload the OTP waveform and voltages themselves (0x22 bit 4)
+    
+    // Full-screen window, counters at X 0 / Y 199 as after initialization
+    setRamWindow(0, MAX_LINE_BYTES - 1, DISPLAY_HEIGHT - 1, 0);
+    return true;
+}
+
+// ===== FULL SCREEN OPERATIONS =====
+
+template <class Bus>
+void GDEH0154D67<Bus>::displayFullScreenMono(const unsigned char* image_data, bool refresh_immediately) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return;
+    }
+    
+    debugPrint("Loading full screen monochrome image");
+    
+    // Send command to write to display RAM
+    writeCommand(0x24);  // Write RAM for black(0)/white(1)
+    
+    // Transfer all 5000 bytes of image data
+    writeDataBlock(image_data, MONO_BUFFER_SIZE);
+    
+    // Trigger refresh if requested
+    if (refresh_immediately) {
+        refreshFull();
+    }
+    
+    debugPrint("Full screen monochrome image loaded");
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::displayFullScreen4Gray(const unsigned char* image_data, bool refresh_immediately) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return;
+    }
+    
+    debugPrint("Loading full screen 4-grayscale image");
+    
+    // 4-grayscale requires writing to both RAM buffers with processed data.
+    // The table-driven splitter runs once per plane, so each RAM buffer goes
+    // out chunk by chunk (one DMA transfer each) without a frame-sized buffer.
+    unsigned char chunk[GRAY_CHUNK_SIZE];
+    unsigned char discard[GRAY_CHUNK_SIZE];
+    
+    // Write to RAM buffer 1
+    writeCommand(0x24);
+    beginDataStream();
+    for (unsigned int i = 0; i < MONO_BUFFER_SIZE; i += GRAY_CHUNK_SIZE) {
+        splitGray4(image_data + 2 * i, chunk, discard, GRAY_CHUNK_SIZE);
+        streamData(chunk, GRAY_CHUNK_SIZE);
+    }
+    endDataStream();
+    
+    // Write to RAM buffer 2
+    writeCommand(0x26);
+    beginDataStream();
+    for (unsigned int i = 0; i < MONO_BUFFER_SIZE; i += GRAY_CHUNK_SIZE) {
+        splitGray4(image_data + 2 * i, discard, chunk, GRAY_CHUNK_SIZE);
+        streamData(chunk, GRAY_CHUNK_SIZE);
+    }
+    endDataStream();
+    
+    // Trigger refresh if requested
+    if (refresh_immediately) {
+        refresh4Grayscale();
+    }
+    
+    debugPrint("Full screen 4-grayscale image loaded");
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::displayGrayPlanes(const GrayPlaneImage& image, bool refresh_immediately) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return;
+    }
+    
+    if (image.ram_24 == nullptr || image.ram_26 == nullptr) {
+        setError("Gray plane image is null");
+        return;
+    }
+    
+    debugPrint("Loading pre-split 4-grayscale planes");
+    
+    writeCommand(0x24);
+    writeDataBlock(image.ram_24, MONO_BUFFER_SIZE);
+    
+    writeCommand(0x26);
+    writeDataBlock(image.ram_26, MONO_BUFFER_SIZE);
+    
+    // Trigger refresh if requested
+    if (refresh_immediately) {
+        refresh4Grayscale();
+    }
+    
+    debugPrint("Pre-split 4-grayscale planes loaded");
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::displayCompressedImage(const unsigned char* asset, bool refresh_immediately) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return false;
+    }
+    
+    GDEH0154D67_AssetDecoder decoder;
+    if (!decoder.begin(asset)) {
+        setError("Invalid compressed image");
+        return false;
+    }
+    
+    bool gray = decoder.kind() == GDEH0154D67_AssetDecoder::ASSET_GRAY_PLANES;
+    if (decoder.rawLength() != (gray ? 2 * MONO_BUFFER_SIZE : MONO_BUFFER_SIZE)) {
+        setError("Compressed image has wrong size");
+        return false;
+    }
+    
+    debugPrint("Loading compressed image");
+    
+    if (!writeDecodedPlane(0x24, decoder) || (gray && !writeDecodedPlane(0x26, decoder))) {
+        setError("Compressed image is corrupt");
+        return false;
+    }
+    
+    // Trigger refresh if requested
+    if (refresh_immediately) {
+        if (gray) {
+            refresh4Grayscale();
+        } else {
+            refreshFull();
+        }
+    }
+    
+    debugPrint("Compressed image loaded");
+    return true;
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::clearScreen(FullRefreshMode mode) {
+    debugPrint("Clearing screen to white");
+    
+    if (!initialized_) {
+        setError("Display not initialized");
+        return;
+    }
+    
+    // The controller fills both planes itself: a few command bytes instead of 10000 data bytes
+    setRamWindow(0, MAX_LINE_BYTES - 1, DISPLAY_HEIGHT - 1, 0);
+    fillRamPattern(0x24, PATTERN_FILL_WHITE);
+    fillRamPattern(0x26, PATTERN_FILL_WHITE);
+    
+    refreshFull(mode);
+    debugPrint("Screen cleared to white");
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::fillRect(const FrameRect& rect, bool white) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return false;
+    }
+    
+    if (rect.x_start_byte > rect.x_end_byte || rect.x_end_byte >= MAX_LINE_BYTES ||
+        rect.row_start > rect.row_end || rect.row_end >= DISPLAY_HEIGHT) {
+        setError("Fill rectangle outside the display");
+        return false;
+    }
+    
+    debugPrint("Filling rectangle");
+    
+    // Reset + border setup, skipped inside a partial session
+    preparePartialUpdate();
+    
+    // The waveform compares against RAM 0x26: make it match the panel where stale
+    presyncOldPlane(rect);
+    
+    unsigned char pattern = white ? PATTERN_FILL_WHITE : PATTERN_FILL_BLACK;
+    setRamWindow(rect.x_start_byte, rect.x_end_byte,
+                 DISPLAY_HEIGHT - 1 - rect.row_end, DISPLAY_HEIGHT - 1 - rect.row_start);
+    fillRamPattern(0x24, pattern);
+    
+    refreshPartial();
+    
+    // Sync the old plane; the window is still set
+    fillRamPattern(0x26, pattern);
+    
+    debugPrint("Rectangle fill completed");
+    return true;
+}
+
+// ===== PARTIAL REFRESH OPERATIONS =====
+
+template <class Bus>
+void GDEH0154D67<Bus>::setPartialRefreshBase(const unsigned char* base_image, FullRefreshMode mode) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return;
+    }
+    
+    debugPrint("Setting partial refresh base image");
+    
+    // For partial refresh, we need to load the base image into both RAM buffers
+    // This ensures partial updates work correctly against a known background
+    
+    // Load base image to RAM buffer 1
+    writeCommand(0x24);
+    writeDataBlock(base_image, MONO_BUFFER_SIZE);
+    
+    // Load same base image to RAM buffer 2 (for partial refresh comparison)
+    writeCommand(0x26);
+    writeDataBlock(base_image, MONO_BUFFER_SIZE);
+    
+    // Display the base image
+    refreshFull(mode);
+    debugPrint("Partial refresh base image set");
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::beginPartialSession() {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return false;
+    }
+    
+    debugPrint("Beginning partial refresh session");
+    
+    partial_session_ = true;
+    controller_mode_ = MODE_OFF;  // Force one reset + border setup now
+    preparePartialUpdate();
+    return true;
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::endPartialSession() {
+    debugPrint("Ending partial refresh session");
+    partial_session_ = false;
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::preparePartialUpdate() {
+    // In a session the controller keeps its partial setup between frames
+    if (partial_session_ && controller_mode_ == MODE_PARTIAL) {
+        return;
+    }
+    
+    // Reset display for partial update; in a session the tracked registers are
+    // trusted and only the differences to the partial setup are written
+    if (!partial_session_ || controller_mode_ == MODE_OFF) {
+        hardwareReset();
+    }
+    
+    // Border setting for partial refresh (plus Y-increment addressing when coming from mono/gray)
+    applyControllerConfig(MODE_PARTIAL);
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::updatePartialRegion(unsigned int x_start, unsigned int y_start,
+                                             const unsigned char* image_data,
+                                             unsigned int width, unsigned int height) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return false;
+    }
+    
+    // Validate coordinates
+    if (x_start + width > DISPLAY_WIDTH || y_start + height > DISPLAY_HEIGHT) {
+        setError("Region coordinates exceed display bounds");
+        return false;
+    }
+    
+    debugPrint("Updating partial region");
+    
+    // Convert pixel coordinates to byte coordinates
+    unsigned int x_start_byte = x_start / 8;
+    unsigned int x_end_byte = x_start_byte + (width / 8) - 1;
+    
+    // Handle Y coordinate addressing (display uses bottom-up addressing)
+    unsigned int y_end = y_start + height - 1;
+    unsigned int data_size = (height * width) / 8;
+    
+    // Reset + border setup, skipped inside a partial session
+    preparePartialUpdate();
+    
+    // The waveform compares against RAM 0x26: make it match the panel where stale
+    if (width >= 8 && height > 0) {
+        presyncOldPlane(FrameRect(x_start_byte, x_end_byte, DISPLAY_HEIGHT - 1 - y_end, DISPLAY_HEIGHT - 1 - y_start));
+    }
+    
+    // Set the partial window and RAM address pointers to start of region
+    setRamWindow(x_start_byte, x_end_byte, y_start, y_end);
+    
+    // Write the partial image data
+    writeCommand(0x24);
+    writeDataBlock(image_data, data_size);
+    
+    // Trigger partial refresh
+    refreshPartial();
+    
+    // Sync the old plane so the next differential update starts from what the panel shows
+    setRamWindow(x_start_byte, x_end_byte, y_start, y_end);
+    writeCommand(0x26);
+    writeDataBlock(image_data, data_size);
+    
+    debugPrint("Partial region update completed");
+    return true;
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::updateMultipleRegions(const PartialRegion regions[5]) {
+    return updateRegions(regions, 5);
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::updateRegions(const PartialRegion* regions, size_t count) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return false;
+    }
+    
+    debugPrint("Starting multiple region update");
+    
+    // Validate coordinates before anything is sent
+    for (size_t region_idx = 0; region_idx < count; region_idx++) {
+        const PartialRegion& region = regions[region_idx];
+        
+        // Skip invalid regions
+        if (!region.isValid()) {
+            continue;
+        }
+        
+        // Data row i lands on RAM Y (y_start - 1 + i): the first row must be on the panel
+        if (region.x_start + region.width > DISPLAY_WIDTH ||
+            region.y_start == 0 || region.y_start > DISPLAY_HEIGHT ||
+            region.height > DISPLAY_HEIGHT || region.width > DISPLAY_WIDTH) {
+            setError("Region coordinates exceed display bounds");
+            return false;
+        }
+    }
+    
+    // Leading regions can share windows; gaps are filled from the shadow. Planning stops at
+    // the first region that overlaps a planned one, so writing the windows first and then the
+    // rest in array order keeps the caller's drawing order.
+    size_t members[MAX_PLANNED_REGIONS];
+    FrameRect member_rects[MAX_PLANNED_REGIONS];
+    unsigned int member_count = 0;
+    size_t planned_end = 0;
+    if (isShadowPlaneValid(PLANE_NEW)) {
+        for (; planned_end < count && member_count < MAX_PLANNED_REGIONS; planned_end++) {
+            if (!regions[planned_end].isValid()) {
+                continue;
+            }
+            FrameRect rect;
+            if (!regionFrameRect(regions[planned_end], rect)) {
+                break;
+            }
+            bool overlaps = false;
+            for (unsigned int m = 0; m < member_count && !overlaps; m++) {
+                overlaps = rect.overlaps(member_rects[m]);
+            }
+            if (overlaps) {
+                break;
+            }
+            members[member_count] = planned_end;
+            member_rects[member_count++] = rect;
+        }
+    }
+    
+    FrameRect windows[MAX_PLANNED_REGIONS];
+    unsigned char assignment[MAX_PLANNED_REGIONS];
+    unsigned int window_count = planWindows(member_rects, member_count, cost_model_, windows, assignment);
+    
+    // Reset + border setup, skipped inside a partial session
+    preparePartialUpdate();
+    
+    // The waveform compares against RAM 0x26: make it match the panel where stale
+    for (unsigned int w = 0; w < window_count; w++) {
+        presyncOldPlane(windows[w]);
+    }
+    for (size_t region_idx = planned_end; region_idx < count; region_idx++) {
+        FrameRect rect;
+        if (regions[region_idx].isValid() && regionFrameRect(regions[region_idx], rect)) {
+            presyncOldPlane(rect);
+        }
+    }
+    
+    // Planned windows: single regions as they are, merged windows composed
+    for (unsigned int w = 0; w < window_count; w++) {
+        size_t window_members[MAX_PLANNED_REGIONS];
+        FrameRect window_rects[MAX_PLANNED_REGIONS];
+        unsigned int window_member_count = 0;
+        for (unsigned int m = 0; m < member_count; m++) {
+            if (assignment[m] == w) {
+                window_members[window_member_count] = members[m];
+                window_rects[window_member_count++] = member_rects[m];
+            }
+        }
+        
+        if (window_member_count == 1) {
+            writeRegion(0x24, regions[window_members[0]]);
+        } else {
+            writeComposedWindow(windows[w], regions, window_members, window_rects, window_member_count);
+        }
+    }
+    
+    // Regions outside the planner keep their own window, in array order
+    for (size_t region_idx = planned_end; region_idx < count; region_idx++) {
+        if (regions[region_idx].isValid()) {
+            writeRegion(0x24, regions[region_idx]);
+        }
+    }
+    
+    // Trigger partial refresh for all regions
+    refreshPartial();
+    
+    // Sync the old plane so the next differential update starts from what the panel shows
+    for (unsigned int w = 0; w < window_count; w++) {
+        // The shadow of 0x24 now holds exactly what was written to the window
+        writeFrameRect(0x26, getShadowPlane(PLANE_NEW), windows[w]);
+    }
+    for (size_t region_idx = planned_end; region_idx < count; region_idx++) {
+        if (regions[region_idx].isValid()) {
+            writeRegion(0x26, regions[region_idx]);
+        }
+    }
+    
+    debugPrint("Multiple region update completed");
+    return true;
+}
+
+template <class Bus>
+const TransferCostModel& GDEH0154D67<Bus>::calibrateCostModel() {
+    debugPrint("Calibrating transfer cost model");
+    
+    unsigned char chunk[FRAME_CHUNK_SIZE];
+    memset(chunk, 0xFF, sizeof(chunk));
+    const unsigned int transactions = 100;
+    
+    // CS stays released: the controller ignores everything clocked out here
+    finishRefresh(0);
+    setCS_Inactive();
+    setDC_Data();
+    
+    unsigned long start_us = bus_.micros();
+    for (unsigned int sent = 0; sent < CALIBRATION_BYTES; sent += FRAME_CHUNK_SIZE) {
+        unsigned int length = CALIBRATION_BYTES - sent < FRAME_CHUNK_SIZE ? CALIBRATION_BYTES - sent : FRAME_CHUNK_SIZE;
+        bus_.writeBlock(chunk, length);
+    }
+    setCS_Inactive();  // Flush batched bytes
+    unsigned long block_us = bus_.micros() - start_us;
+    
+    start_us = bus_.micros();
+    for (unsigned int i = 0; i < transactions; i++) {
+        setDC_Data();
+        bus_.write(0xFF);
+        setCS_Inactive();
+    }
+    unsigned long transactions_us = bus_.micros() - start_us;
+    
+    if (block_us == 0 || transactions_us == 0) {
+        debugPrint("Bus has no time base, keeping cost model");
+        return cost_model_;
+    }
+    
+    cost_model_.byte_us = static_cast<float>(block_us) / CALIBRATION_BYTES;
+    cost_model_.transaction_us = static_cast<float>(transactions_us) / transactions - cost_model_.byte_us;
+    if (cost_model_.transaction_us < 0.0f) {
+        cost_model_.transaction_us = 0.0f;
+    }
+    
+    debugPrint("Transfer cost model calibrated");
+    return cost_model_;
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::regionFrameRect(const PartialRegion& region, FrameRect& rect) {
+    // Legacy addressing: data row i lands on RAM Y (y_start - 1 + i) = frame row (200 - y_start - i).
+    // Rows past RAM Y 199 are dropped by the controller; the rect keeps the visible ones.
+    if (region.y_start == 0 || region.y_start > DISPLAY_HEIGHT) {
+        return false;
+    }
+    
+    rect.x_start_byte = region.x_start / 8;
+    rect.x_end_byte = rect.x_start_byte + (region.width / 8) - 1;
+    rect.row_end = DISPLAY_HEIGHT - region.y_start;
+    rect.row_start = region.height > rect.row_end ? 0 : rect.row_end + 1 - region.height;
+    return region.width >= 8 && rect.x_end_byte < MAX_LINE_BYTES;
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::writeRegion(unsigned char ram_command, const PartialRegion& region) {
+    // Convert coordinates and configure window
+    unsigned int x_start_byte = region.x_start / 8;
+    unsigned int x_end_byte = x_start_byte + (region.width / 8) - 1;
+    
+    // Set window and RAM address for this region
+    setRamWindow(x_start_byte, x_end_byte,
+                 region.y_start - 1,                    // Adjust for display addressing
+                 region.y_start + region.height - 1);
+    
+    // Write region data
+    writeCommand(ram_command);
+    unsigned int data_size = (region.height * region.width) / 8;
+    writeDataBlock(region.data, data_size);
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::writeComposedWindow(const FrameRect& window, const PartialRegion* regions,
+                                             const size_t* members, const FrameRect* rects,
+                                             unsigned int member_count) {
+    // Frame row r is RAM Y 199-r; after the partial reset the controller increments Y
+    setRamWindow(window.x_start_byte, window.x_end_byte,
+                 DISPLAY_HEIGHT - 1 - window.row_end, DISPLAY_HEIGHT - 1 - window.row_start);
+    writeCommand(0x24);
+    
+    const unsigned char* shown = getShadowPlane(PLANE_NEW);
+    unsigned char chunk[FRAME_CHUNK_SIZE];
+    unsigned int row_bytes = window.x_end_byte - window.x_start_byte + 1;
+    unsigned int fill = 0;
+    
+    beginDataStream();
+    for (unsigned int row = window.row_end + 1; row-- > window.row_start; ) {
+        if (fill + row_bytes > FRAME_CHUNK_SIZE) {
+            streamData(chunk, fill);
+            fill = 0;
+        }
+        
+        // Gaps keep what the panel shows; members overwrite in update order
+        memcpy(chunk + fill, shown + row * MAX_LINE_BYTES + window.x_start_byte, row_bytes);
+        for (unsigned int m = 0; m < member_count; m++) {
+            const FrameRect& rect = rects[m];
+            if (row < rect.row_start || row > rect.row_end) {
+                continue;
+            }
+            unsigned int rect_bytes = rect.x_end_byte - rect.x_start_byte + 1;
+            const unsigned char* source = regions[members[m]].data + (rect.row_end - row) * rect_bytes;
+            memcpy_P(chunk + fill + (rect.x_start_byte - window.x_start_byte), source, rect_bytes);
+        }
+        fill += row_bytes;
+    }
+    streamData(chunk, fill);
+    endDataStream();
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::updateFromFrame(const unsigned char* frame) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return false;
+    }
+    
+    if (shadow_ == nullptr) {
+        setError("Shadow buffer required for frame updates");
+        return false;
+    }
+    
+    FrameRect rects[MAX_DIRTY_RECTS];
+    unsigned int rect_count;
+    if (isShadowPlaneValid(PLANE_NEW)) {
+        rect_count = findDirtyRects(getShadowPlane(PLANE_NEW), frame, rects, MAX_DIRTY_RECTS);
+    } else {
+        // Panel content unknown: one full window establishes it
+        rects[0] = FrameRect(0, MAX_LINE_BYTES - 1, 0, DISPLAY_HEIGHT - 1);
+        rect_count = 1;
+    }
+    
+    if (rect_count == 0) {
+        debugPrint("Frame unchanged, no refresh needed");
+        return true;
+    }
+    
+    debugPrint("Updating changed frame areas");
+    
+    // Reset + border setup, skipped inside a partial session
+    preparePartialUpdate();
+    
+    // The waveform compares against RAM 0x26: make it match the panel where stale (e.g. after a full refresh)
+    for (unsigned int i = 0; i < rect_count; i++) {
+        presyncOldPlane(rects[i]);
+    }
+    
+    for (unsigned int i = 0; i < rect_count; i++) {
+        writeFrameRect(0x24, frame, rects[i]);
+    }
+    
+    refreshPartial();
+    
+    // Sync the old plane so the next differential update starts from what the panel shows
+    for (unsigned int i = 0; i < rect_count; i++) {
+        writeFrameRect(0x26, frame, rects[i]);
+    }
+    
+    debugPrint("Frame update completed");
+    return true;
+}
+
+template <class Bus>
+RefreshHandle GDEH0154D67<Bus>::updateFrameRectsAsync(const unsigned char* frame, const FrameRect* rects, size_t count) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return RefreshHandle();
+    }
+    
+    if (shadow_ == nullptr || !isShadowPlaneValid(PLANE_NEW)) {
+        setError("Shadow of the shown frame required for frame updates");
+        return RefreshHandle();
+    }
+    
+    if (frame == nullptr || count == 0) {
+        setError("No frame rectangles to update");
+        return RefreshHandle();
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (rects[i].x_start_byte > rects[i].x_end_byte || rects[i].x_end_byte >= MAX_LINE_BYTES ||
+            rects[i].row_start > rects[i].row_end || rects[i].row_end >= DISPLAY_HEIGHT) {
+            setError("Frame rectangle outside the display");
+            return RefreshHandle();
+        }
+    }
+    
+    debugPrint("Updating frame rectangles asynchronously");
+    
+    // Reset + border setup, skipped inside a partial session
+    preparePartialUpdate();
+    
+    // The waveform compares against RAM 0x26: make it match the panel where stale
+    for (size_t i = 0; i < count; i++) {
+        presyncOldPlane(rects[i]);
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        writeFrameRect(0x24, frame, rects[i]);
+    }
+    
+    return refreshPartialAsync();
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::syncOldPlane(const FrameRect* rects, size_t count) {
+    if (shadow_ == nullptr || !isShadowPlaneValid(PLANE_NEW)) {
+        return;
+    }
+    
+    finishRefresh(0);
+    
+    const unsigned char* shown = getShadowPlane(PLANE_NEW);
+    for (size_t i = 0; i < count; i++) {
+        writeFrameRect(0x26, shown, rects[i]);
+    }
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::applyFrameDelta(const unsigned char* delta) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return false;
+    }
+    
+    if (shadow_ == nullptr || !isShadowPlaneValid(PLANE_NEW)) {
+        setError("Shadow of the shown frame required for deltas");
+        return false;
+    }
+    
+    // Validate all records before touching controller RAM
+    if (!validateFrameDelta(delta)) {
+        setError("Invalid frame delta");
+        return false;
+    }
+    
+    unsigned int record_count = pgm_read_byte(&delta[3]);
+    if (record_count == 0) {
+        debugPrint("Frame delta is empty, no refresh needed");
+        return true;
+    }
+    
+    debugPrint("Applying frame delta");
+    
+    // Reset + border setup, skipped inside a partial session
+    preparePartialUpdate();
+    
+    FrameRect rect;
+    const unsigned char* record;
+    const unsigned char* shown = getShadowPlane(PLANE_NEW);
+    
+    // The waveform compares against RAM 0x26: make it match the panel where stale
+    record = delta + DELTA_HEADER_SIZE;
+    for (unsigned int i = 0; i < record_count; i++) {
+        record = readDeltaRecord(record, rect) + rect.byteCount();
+        presyncOldPlane(rect);
+    }
+    
+    record = delta + DELTA_HEADER_SIZE;
+    for (unsigned int i = 0; i < record_count; i++) {
+        const unsigned char* xor_data = readDeltaRecord(record, rect);
+        writeDeltaRect(rect, xor_data);
+        record = xor_data + rect.byteCount();
+    }
+    
+    refreshPartial();
+    
+    // The shadow now holds the new frame; sync the old plane from it
+    record = delta + DELTA_HEADER_SIZE;
+    for (unsigned int i = 0; i < record_count; i++) {
+        record = readDeltaRecord(record, rect) + rect.byteCount();
+        writeFrameRect(0x26, shown, rect);
+    }
+    
+    debugPrint("Frame delta applied");
+    return true;
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::displayAsset(unsigned int id, bool refresh_immediately) {
+    if (asset_pack_ == nullptr || !asset_pack_->isOpen()) {
+        setError("No asset pack");
+        return false;
+    }
+    
+    unsigned char kind = 0;
+    size_t length = 0;
+    const unsigned char* data = asset_pack_->find(id, &kind, &length);
+    if (data == nullptr) {
+        setError("Unknown asset ID");
+        return false;
+    }
+    
+    switch (kind) {
+    case GDEH0154D67_AssetPack::KIND_MONO:
+        if (length != MONO_BUFFER_SIZE) {
+            break;
+        }
+        displayFullScreenMono(data, refresh_immediately);
+        return initialized_;
+    case GDEH0154D67_AssetPack::KIND_GRAY_PLANES:
+        if (length != 2 * MONO_BUFFER_SIZE) {
+            break;
+        }
+        displayGrayPlanes(GrayPlaneImage{ data, data + MONO_BUFFER_SIZE }, refresh_immediately);
+        return initialized_;
+    case GDEH0154D67_AssetPack::KIND_COMPRESSED:
+        // The container's payload must not run past its pack entry
+        if (length < GDEH0154D67_AssetDecoder::HEADER_SIZE ||
+            length - GDEH0154D67_AssetDecoder::HEADER_SIZE < (size_t)(data[6] | (data[7] << 8))) {
+            break;
+        }
+        return displayCompressedImage(data, refresh_immediately);
+    case GDEH0154D67_AssetPack::KIND_DELTA:
+        if (length < DELTA_HEADER_SIZE || length - DELTA_HEADER_SIZE < (size_t)(data[4] | (data[5] << 8))) {
+            break;
+        }
+        return applyFrameDelta(data);
+    default:
+        break;
+    }
+    
+    setError("Invalid asset in pack");
+    return false;
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::updateFaceRegion(const FaceRegion& region, const unsigned char* image_data) {
+    FaceRegionPatch patch = {
+        &region, image_data, FrameRect(region.x_start_byte, region.x_end_byte, region.row_start, region.row_end)
+    };
+    return updateFaceRegions(&patch, 1);
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::updateFaceRegions(const FaceRegionPatch* patches, size_t count) {
+    if (!initialized_) {
+        setError("Display not initialized");
+        return false;
+    }
+    
+    // Validate all patches before touching controller RAM
+    for (size_t i = 0; i < count; i++) {
+        const FaceRegionPatch& patch = patches[i];
+        if (patch.region == nullptr || patch.data == nullptr) {
+            setError("Face region data is null");
+            return false;
+        }
+        const FaceRegion& region = *patch.region;
+        if (patch.rect.x_start_byte > patch.rect.x_end_byte || patch.rect.row_start > patch.rect.row_end ||
+            patch.rect.x_start_byte < region.x_start_byte || patch.rect.x_end_byte > region.x_end_byte ||
+            patch.rect.row_start < region.row_start || patch.rect.row_end > region.row_end) {
+            setError("Face region patch outside its region");
+            return false;
+        }
+    }
+    
+    if (count == 0) {
+        debugPrint("No face region changes, no refresh needed");
+        return true;
+    }
+    
+    debugPrint("Updating face regions");
+    
+    // Reset + border setup, skipped inside a partial session
+    preparePartialUpdate();
+    
+    // The waveform compares against RAM 0x26: make it match the panel where stale
+    for (size_t i = 0; i < count; i++) {
+        presyncOldPlane(patches[i].rect);
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        writeFaceRegionPatch(0x24, patches[i]);
+    }
+    
+    refreshPartial();
+    
+    // Sync the old plane so the next differential update starts from what the panel shows
+    for (size_t i = 0; i < count; i++) {
+        writeFaceRegionPatch(0x26, patches[i]);
+    }
+    
+    debugPrint("Face region update completed");
+    return true;
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::writeDecodedPlane(unsigned char ram_command, GDEH0154D67_AssetDecoder& decoder) {
+    unsigned char chunk[DECODE_CHUNK_SIZE];
+    size_t remaining = MONO_BUFFER_SIZE;
+    
+    writeCommand(ram_command);
+    beginDataStream();
+    while (remaining > 0) {
+        size_t count = decoder.read(chunk, remaining < DECODE_CHUNK_SIZE ? remaining : DECODE_CHUNK_SIZE);
+        if (count == 0) {
+            break;
+        }
+        streamData(chunk, count);
+        remaining -= count;
+    }
+    endDataStream();
+    
+    return remaining == 0;
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::presyncOldPlane(const FrameRect& rect) {
+    if (shadow_ == nullptr || !isShadowPlaneValid(PLANE_NEW)) {
+        return;
+    }
+    const unsigned char* shown = getShadowPlane(PLANE_NEW);
+    if (!isShadowPlaneValid(PLANE_OLD) || !rectsEqual(getShadowPlane(PLANE_OLD), shown, rect)) {
+        writeFrameRect(0x26, shown, rect);
+    }
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::writeFrameRect(unsigned char ram_command, const unsigned char* frame,
+                                        const FrameRect& rect) {
+    // Frame row r is RAM Y 199-r; after the partial reset the controller increments Y
+    setRamWindow(rect.x_start_byte, rect.x_end_byte,
+                 DISPLAY_HEIGHT - 1 - rect.row_end, DISPLAY_HEIGHT - 1 - rect.row_start);
+    writeCommand(ram_command);
+    
+    // Gather the strided rows into chunks so each chunk goes out as one transfer
+    unsigned char chunk[FRAME_CHUNK_SIZE];
+    unsigned int row_bytes = rect.x_end_byte - rect.x_start_byte + 1;
+    unsigned int fill = 0;
+    
+    beginDataStream();
+    for (unsigned int row = rect.row_end + 1; row-- > rect.row_start; ) {
+        if (fill + row_bytes > FRAME_CHUNK_SIZE) {
+            streamData(chunk, fill);
+            fill = 0;
+        }
+        memcpy_P(chunk + fill, frame + row * MAX_LINE_BYTES + rect.x_start_byte, row_bytes);
+        fill += row_bytes;
+    }
+    streamData(chunk, fill);
+    endDataStream();
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::writeDeltaRect(const FrameRect& rect, const unsigned char* xor_data) {
+    setRamWindow(rect.x_start_byte, rect.x_end_byte,
+                 DISPLAY_HEIGHT - 1 - rect.row_end, DISPLAY_HEIGHT - 1 - rect.row_start);
+    writeCommand(0x24);
+    
+    // Each chunk is built from the shadow before the shadow hook overwrites those bytes
+    const unsigned char* shown = getShadowPlane(PLANE_NEW);
+    unsigned char chunk[FRAME_CHUNK_SIZE];
+    unsigned int row_bytes = rect.x_end_byte - rect.x_start_byte + 1;
+    unsigned int fill = 0;
+    
+    beginDataStream();
+    for (unsigned int row = rect.row_end + 1; row-- > rect.row_start; ) {
+        if (fill + row_bytes > FRAME_CHUNK_SIZE) {
+            streamData(chunk, fill);
+            fill = 0;
+        }
+        const unsigned char* line = shown + row * MAX_LINE_BYTES + rect.x_start_byte;
+        for (unsigned int x = 0; x < row_bytes; x++) {
+            chunk[fill + x] = line[x] ^ pgm_read_byte(xor_data++);
+        }
+        fill += row_bytes;
+    }
+    streamData(chunk, fill);
+    endDataStream();
+}
+
+// ===== DISPLAY REFRESH & UPDATE =====
+
+template <class Bus>
+void GDEH0154D67<Bus>::refreshFull(FullRefreshMode mode) {
+    debugPrint(mode == FULL_REFRESH_FAST ? "Triggering fast full screen refresh" : "Triggering full screen refresh");
+    
+    if (mode == FULL_REFRESH_FAST) {
+        loadFastWaveform();
+        startRefresh(0xC7, nullptr, nullptr);  // Display mode 1 with the waveform just loaded
+    } else {
+        startRefresh(0xF7, nullptr, nullptr);  // Full refresh with flicker
+    }
+    finishRefresh(0);    // Wait for refresh to complete
+    
+    debugPrint("Full screen refresh completed");
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::refreshPartial() {
+    debugPrint("Triggering partial refresh");
+    
+    startRefresh(preparePartialWaveform(), nullptr, nullptr);  // Partial refresh without flicker
+    finishRefresh(0);    // Wait for refresh to complete
+    
+    debugPrint("Partial refresh completed");
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::refresh4Grayscale() {
+    debugPrint("Triggering 4-grayscale refresh");
+    
+    startRefresh(0xC7, nullptr, nullptr);  // 4-grayscale refresh mode
+    finishRefresh(0);    // Wait for refresh to complete
+    
+    debugPrint("4-grayscale refresh completed");
+}
+
+// ===== ASYNCHRONOUS REFRESH =====
+
+template <class Bus>
+RefreshHandle GDEH0154D67<Bus>::refreshFullAsync(RefreshCallback callback, void* context, FullRefreshMode mode) {
+    debugPrint("Starting asynchronous full screen refresh");
+    if (mode == FULL_REFRESH_FAST) {
+        loadFastWaveform();
+        return startRefresh(0xC7, callback, context);
+    }
+    return startRefresh(0xF7, callback, context);
+}
+
+template <class Bus>
+RefreshHandle GDEH0154D67<Bus>::refreshPartialAsync(RefreshCallback callback, void* context) {
+    debugPrint("Starting asynchronous partial refresh");
+    return startRefresh(preparePartialWaveform(), callback, context);
+}
+
+template <class Bus>
+RefreshHandle GDEH0154D67<Bus>::refresh4GrayscaleAsync(RefreshCallback callback, void* context) {
+    debugPrint("Starting asynchronous 4-grayscale refresh");
+    return startRefresh(0xC7, callback, context);
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::isRefreshComplete(RefreshHandle handle) {
+    // Older handles were completed before the newer refresh could start
+    if (!refresh_pending_ || handle.id != refresh_id_) {
+        return true;
+    }
+    if (readBusy()) {
+        return false;
+    }
+    return finishRefresh(0);  // BUSY already low: returns at once and runs the callback
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::waitRefresh(RefreshHandle handle, unsigned long timeout_ms) {
+    if (!refresh_pending_ || handle.id != refresh_id_) {
+        return true;
+    }
+    return finishRefresh(timeout_ms);
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::poll() {
+    if (refresh_pending_ && !readBusy()) {
+        finishRefresh(0);
+    }
+    return refresh_pending_;
+}
+
+template <class Bus>
+RefreshHandle GDEH0154D67<Bus>::startRefresh(unsigned char update_mode, RefreshCallback callback, void* context) {
+    writeCommand(0x22);  // Display Update Control (completes any pending refresh first)
+    writeData(update_mode);
+    writeCommand(0x20);  // Activate Display Update Sequence
+    if (update_mode & 0x10) {
+        loaded_lut_ = LUT_OTP;  // OTP load replaces LUT and voltages
+    }
+    
+    refresh_id_++;
+    if (refresh_id_ == 0) {
+        refresh_id_ = 1;  // 0 marks an invalid handle
+    }
+    refresh_pending_ = true;
+    refresh_callback_ = callback;
+    refresh_context_ = context;
+    return RefreshHandle(refresh_id_);
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::finishRefresh(unsigned long timeout_ms) {
+    if (!refresh_pending_) {
+        return true;
+    }
+    
+    if (!bus_.waitIdle(timeout_ms)) {
+        setError("Timeout waiting for refresh to complete");
+        return false;
+    }
+    
+    // Clear state before the callback so it may start the next refresh
+    refresh_pending_ = false;
+    RefreshCallback callback = refresh_callback_;
+    refresh_callback_ = nullptr;
+    if (callback != nullptr) {
+        callback(RefreshHandle(refresh_id_), refresh_context_);
+    }
+    return true;
+}
+
+// ===== POWER MANAGEMENT =====
+
+template <class Bus>
+void GDEH0154D67<Bus>::enterDeepSleep() {
+    debugPrint("Entering deep sleep mode");
+    
+    writeCommand(0x10);  // Enter deep sleep command
+    writeData(0x01);     // Deep sleep mode parameter
+    bus_.delayMs(100);   // Allow time for sleep transition
+    
+    initialized_ = false;  // Display will need re-initialization
+    controller_mode_ = MODE_OFF;
+    loaded_lut_ = LUT_NONE;
+    config_.known = 0;
+    debugPrint("Deep sleep mode activated");
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::isBusy() {
+    return readBusy();
+}
+
+template <class Bus>
+bool GDEH0154D67<Bus>::waitForReady(unsigned long timeout_ms) {
+    if (refresh_pending_) {
+        return finishRefresh(timeout_ms);  // Also runs the completion callback
+    }
+    
+    if (!bus_.waitIdle(timeout_ms)) {
+        setError("Timeout waiting for display ready");
+        return false;
+    }
+    
+    return true;
+}
+
+// ===== LOW-LEVEL SPI COMMUNICATION =====
+
+template <class Bus>
+void GDEH0154D67<Bus>::writeCommand(unsigned char cmd) {
+    finishRefresh(0);   // Controller ignores commands while an async refresh runs
+    setCS_Active();     // Select display
+    setDC_Command();    // Set to command mode
+    bus_.write(cmd);    // Send command byte
+    setCS_Inactive();   // Deselect display
+    
+    if (shadow_ != nullptr) {
+        shadowTrackCommand(cmd);
+    }
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::writeData(unsigned char data) {
+    setCS_Active();     // Select display
+    setDC_Data();       // Set to data mode
+    bus_.write(data);   // Send data byte
+    setCS_Inactive();   // Deselect display
+    
+    if (shadow_ != nullptr) {
+        shadowTrackData(&data, 1);
+    }
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::writeDataBlock(const unsigned char* data, size_t length) {
+    beginDataStream();
+    streamData(data, length);
+    endDataStream();
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::beginDataStream() {
+    setCS_Active();     // Select display for the whole payload
+    setDC_Data();       // DC is driven once, not per byte
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::streamData(unsigned char data) {
+    bus_.write(data);   // Hardware buses batch these into DMA transfers
+    
+    if (shadow_ != nullptr) {
+        shadowTrackData(&data, 1);
+    }
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::streamData(const unsigned char* data, size_t length) {
+    bus_.writeBlock(data, length);
+    
+    if (shadow_ != nullptr) {
+        shadowTrackData(data, length);
+    }
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::runCommandSequence(const InitCommand* sequence, size_t length) {
+    finishRefresh(0);   // Controller ignores commands while an async refresh runs
+    
+    bool selected = false;
+    for (size_t i = 0; i < length; i++) {
+        const InitCommand& command = sequence[i];
+        if (!selected) {
+            setCS_Active();
+            selected = true;
+        }
+        
+        setDC_Command();
+        bus_.write(command.opcode);
+        if (shadow_ != nullptr) {
+            shadowTrackCommand(command.opcode);
+        }
+        
+        if (command.arg_count > 0) {
+            setDC_Data();
+            bus_.writeBlock(command.args, command.arg_count);
+            if (shadow_ != nullptr) {
+                shadowTrackData(command.args, command.arg_count);
+            }
+        }
+        
+        if (command.wait_busy) {
+            setCS_Inactive();  // Flushes batched bytes before BUSY is sampled
+            selected = false;
+            waitBusy();
+        }
+    }
+    if (selected) {
+        setCS_Inactive();
+    }
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::endDataStream() {
+    setCS_Inactive();   // Deselect display (flushes any batched bytes first)
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::waitBusy() {
+    // Wait while BUSY signal is high (display is busy); the bus sleeps on the BUSY edge
+    bus_.waitIdle(0);
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::setRamWindow(unsigned int x_start_byte, unsigned int x_end_byte,
+                                      unsigned int y_start, unsigned int y_end) {
+    // Set the window X range
+    writeCommand(0x44);
+    writeData(x_start_byte);    // X start
+    writeData(x_end_byte);      // X end
+    
+    // Set the window Y range
+    writeCommand(0x45);
+    writeData(y_start % 256);   // Y start low
+    writeData(y_start / 256);   // Y start high
+    writeData(y_end % 256);     // Y end low
+    writeData(y_end / 256);     // Y end high
+    
+    // Set RAM address pointers to start of window
+    writeCommand(0x4E);
+    writeData(x_start_byte);
+    writeCommand(0x4F);
+    writeData(y_start % 256);
+    writeData(y_start / 256);
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::setFaceRegionWindow(const FaceRegion& region) {
+    // Arguments go out as one block per command: no per-byte CS transactions
+    writeCommand(0x44);
+    writeDataBlock(region.ram_x_window, sizeof(region.ram_x_window));
+    writeCommand(0x45);
+    writeDataBlock(region.ram_y_window, sizeof(region.ram_y_window));
+    writeCommand(0x4E);
+    writeDataBlock(&region.ram_x_counter, 1);
+    writeCommand(0x4F);
+    writeDataBlock(region.ram_y_counter, sizeof(region.ram_y_counter));
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::loadFastWaveform() {
+    // The OTP holds one waveform per temperature range; hot ones drive the panel for fewer frames
+    writeCommand(0x1A);  // Temperature register write
+    writeData(FAST_REFRESH_TEMPERATURE);
+    writeData(0x00);     // Fraction bits
+    writeCommand(0x22);  // Display update control
+    writeData(0x91);     // Clock on, load LUT for the register temperature, clock off
+    writeCommand(0x20);  // Activate
+    loaded_lut_ = LUT_OTP;
+    waitBusy();
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::fillRamPattern(unsigned char ram_command, unsigned char pattern) {
+    writeCommand(ram_command == 0x24 ? 0x47 : 0x46);  // Auto write BW / RED RAM for regular pattern
+    writeData(pattern);
+    waitBusy();  // BUSY stays high while the controller writes RAM
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::writeFaceRegionPatch(unsigned char ram_command, const FaceRegionPatch& patch) {
+    const FaceRegion& region = *patch.region;
+    const FrameRect& rect = patch.rect;
+    unsigned int region_bytes = region.x_end_byte - region.x_start_byte + 1;
+    unsigned int row_bytes = rect.x_end_byte - rect.x_start_byte + 1;
+    
+    // Image rows run bottom-up from region.row_end
+    const unsigned char* first = patch.data + (region.row_end - rect.row_end) * region_bytes +
+                                 (rect.x_start_byte - region.x_start_byte);
+    
+    if (rect.x_start_byte == region.x_start_byte && rect.x_end_byte == region.x_end_byte &&
+        rect.row_start == region.row_start && rect.row_end == region.row_end) {
+        setFaceRegionWindow(region);
+    } else {
+        setRamWindow(rect.x_start_byte, rect.x_end_byte,
+                     DISPLAY_HEIGHT - 1 - rect.row_end, DISPLAY_HEIGHT - 1 - rect.row_start);
+    }
+    writeCommand(ram_command);
+    
+    // Full-width rows are contiguous in the image: one block, no copy
+    if (row_bytes == region_bytes) {
+        writeDataBlock(first, rect.byteCount());
+        return;
+    }
+    
+    unsigned char chunk[FRAME_CHUNK_SIZE];
+    unsigned int fill = 0;
+    
+    beginDataStream();
+    for (unsigned int row = 0; row <= rect.row_end - rect.row_start; row++) {
+        if (fill + row_bytes > FRAME_CHUNK_SIZE) {
+            streamData(chunk, fill);
+            fill = 0;
+        }
+        memcpy_P(chunk + fill, first + row * region_bytes, row_bytes);
+        fill += row_bytes;
+    }
+    streamData(chunk, fill);
+    endDataStream();
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::hardwareReset() {
+    setRST_Active();     // Assert reset (low)
+    bus_.delayMs(10);    // Hold reset for at least 10ms
+    setRST_Inactive();   // Release reset (high)
+    bus_.delayMs(10);    // Wait for display to boot
+    
+    controller_mode_ = MODE_OFF;  // Registers are back at their power-on defaults
+    loaded_lut_ = LUT_NONE;
+    config_ = MODE_CONFIGS[MODE_OFF];
+    if (shadow_ != nullptr) {
+        shadowTrackReset();
+    }
+}
+
+// ===== WAVEFORMS & CONTROLLER CONFIGURATION =====
+
+template <class Bus>
+void GDEH0154D67<Bus>::loadCustomWaveform(LoadedLut lut, const unsigned char* wave_data) {
+    if (loaded_lut_ == lut) {
+        return;  // Still in the LUT register since the last load
+    }
+    
+    writeCommand(0x32);  // Load LUT command
+    writeDataBlock(wave_data, 153);
+    
+    writeCommand(0x3F);  // EOPQ
+    writeData(wave_data[153]);
+    writeCommand(0x03);  // VGH
+    writeData(wave_data[154]);
+    writeCommand(0x04);  // VSH1, VSH2, VSL
+    writeDataBlock(&wave_data[155], 3);
+    writeCommand(0x2C);  // VCOM voltage
+    writeData(wave_data[158]);
+    
+    loaded_lut_ = lut;
+}
+
+template <class Bus>
+void GDEH0154D67<Bus>::applyControllerConfig(ControllerMode mode) {
+    const ControllerConfig& target = MODE_CONFIGS[mode];
+    
+    for (unsigned int reg = 0; reg < CONFIG_REGISTER_COUNT; reg++) {
+        unsigned char bit = 1 << reg;
+        if (!(target.known & bit) ||
+            ((config_.known & bit) && config_.value[reg] == target.value[reg])) {
+            continue;  // Not needed by the mode or already set
+        }
+        writeCommand(CONFIG_COMMANDS[reg]);
+        writeData(target.value[reg]);
+        if (reg == CONFIG_DRIVER_OUTPUT) {
+            writeData(0x00);
+            writeData(0x00);
+        }
+    }
+    
+    trackControllerConfig(mode);
+    controller_mode_ = mode;
+}
+
+template <class Bus>
+unsigned char GDEH0154D67<Bus>::preparePartialWaveform() {
+    if (partial_waveform_ == PARTIAL_WAVEFORM_FAST) {
+        loadCustomWaveform(LUT_PARTIAL_FAST, LUT_DATA_PartialFast);
+        return 0xCF;  // Clock + analog on, display mode 2 with the loaded LUT, analog + clock off
+    }
+    return 0xFF;      // Also reloads temperature and OTP LUT
+}
+
+#endif // GDEH0154D67_DISPLAY_IMPL_H
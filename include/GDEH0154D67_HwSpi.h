@@ -0,0 +1,84 @@
+/**
+ * @file GDEH0154D67_HwSpi.h
+ * @brief Hardware SPI (VSPI/HSPI) transport with DMA for the GDEH0154D67 display
+ *
+ * The SSD1681 only ever receives data from the host, so the transport is
+ * write-only: MOSI and SCK are driven by an ESP32 SPI peripheral while CS,
+ * DC, RST and BUSY stay plain GPIOs owned by the display driver.
+ *
+ * Single command/data bytes are sent as polled transactions (lowest latency
+ * for short register writes). Bulk RAM uploads (0x24/0x26) are split into
+ * chunks that are copied into DMA-capable bounce buffers and queued, so the
+ * copy of chunk N+1 overlaps with the DMA transfer of chunk N. The bounce
+ * buffers are required because the SPI DMA engine cannot read directly from
+ * flash-mapped (PROGMEM) image arrays.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef GDEH0154D67_HWSPI_H
+#define GDEH0154D67_HWSPI_H
+
+#include <Arduino.h>
+#include <driver/spi_master.h>
+
+/**
+ * @brief Write-only hardware SPI transport used for display RAM uploads
+ */
+class GDEH0154D67_HwSpi {
+public:
+    static constexpr uint32_t DEFAULT_CLOCK_HZ = 20000000; ///< SSD1681 max write clock (50ns cycle)
+    static constexpr size_t DMA_CHUNK_SIZE = 1000;         ///< Bytes per DMA transaction (5 per mono frame)
+
+    GDEH0154D67_HwSpi();
+    ~GDEH0154D67_HwSpi();
+
+    /**
+     * @brief Claim an SPI peripheral and attach the display as a write-only device
+     * @param sck_pin GPIO used for SCK
+     * @param mosi_pin GPIO used for MOSI/SDI
+     * @param clock_hz SPI clock frequency
+     * @return true if the bus is ready, false if the pins cannot be driven by
+     *         the SPI peripheral or the driver could not be installed
+     * @note HSPI is selected when the pins match its IO_MUX pins (SCK=14, MOSI=13),
+     *       VSPI otherwise (IO_MUX pins SCK=18, MOSI=23; any other output pins are
+     *       routed through the GPIO matrix)
+     */
+    bool begin(int sck_pin, int mosi_pin, uint32_t clock_hz = DEFAULT_CLOCK_HZ);
+
+    /**
+     * @brief Release the SPI device, bus and DMA buffers
+     */
+    void end();
+
+    /**
+     * @brief Check whether the hardware transport is ready for use
+     */
+    bool isActive() const { return active_; }
+
+    /**
+     * @brief Send a single byte (polled transaction, no DMA)
+     * @param value Byte to transmit
+     */
+    void writeByte(uint8_t value);
+
+    /**
+     * @brief Send a buffer using DMA
+     * @param data Source bytes (RAM or flash-mapped PROGMEM)
+     * @param length Number of bytes to send (0 sends nothing)
+     * @note Blocks until the last chunk has been clocked out, so CS may be
+     *       released by the caller immediately afterwards
+     */
+    void writeBuffer(const uint8_t* data, size_t length);
+
+private:
+    spi_host_device_t host_;          ///< SPI peripheral in use (SPI2_HOST=HSPI, SPI3_HOST=VSPI)
+    spi_device_handle_t device_;      ///< Attached display device
+    uint8_t* dma_buffers_[2];         ///< Double-buffered DMA-capable bounce buffers
+    spi_transaction_t transactions_[2]; ///< Transactions for the two bounce buffers
+    bool active_;                     ///< Whether begin() succeeded
+};
+
+#endif // GDEH0154D67_HWSPI_H
@@ -0,0 +1,218 @@
+/**
+ * @file GDEH0154D67_Mailbox.h
+ * @brief Latest-wins frame mailbox that merges updates arriving during a refresh
+ *
+ * A partial refresh keeps BUSY high for a few hundred milliseconds. Requests
+ * posted meanwhile are drawn into one pending target frame and their dirty
+ * rectangles are unioned; when the panel is free again the whole set goes out
+ * with a single partial refresh. However often the application posts, the
+ * panel refreshes at most once per waveform and always shows the newest state.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef GDEH0154D67_MAILBOX_H
+#define GDEH0154D67_MAILBOX_H
+
+#include "GDEH0154D67_Display.h"
+
+/**
+ * @brief Counters of a GDEH0154D67_Mailbox
+ */
+struct MailboxStats {
+    unsigned long posts;            ///< Frames and regions posted
+    unsigned long commits;          ///< Partial refreshes started
+    unsigned long merged;           ///< Posts folded into an already pending update
+};
+
+/**
+ * @brief Pending target frame plus dirty set in front of a display driver
+ * @tparam Display Driver type, e.g. GDEH0154D67_Display
+ *
+ * Posts and service() must come from the task that owns the driver. Drawing
+ * on the driver directly bypasses the mailbox; call begin() afterwards to
+ * take the shown frame over again.
+ */
+template <class Display>
+class GDEH0154D67_Mailbox {
+public:
+    static constexpr unsigned int MAX_RECTS = 16;        ///< Rectangles per commit (as updateFromFrame())
+    static constexpr unsigned int LINE_BYTES = GDEH0154D67_Base::getWidth() / 8;   ///< Bytes per frame row
+    static constexpr unsigned int ROWS = GDEH0154D67_Base::getHeight();            ///< Frame rows
+
+    explicit GDEH0154D67_Mailbox(Display& display)
+        : display_(display), dirty_count_(0), inflight_count_(0) {
+        memset(pending_, 0, sizeof(pending_));
+        memset(&stats_, 0, sizeof(stats_));
+    }
+
+    /**
+     * @brief Start from the frame the panel shows
+     * @return false if the driver has no valid shadow of RAM 0x24
+     */
+    bool begin() {
+        const unsigned char* shown = display_.getShadowPlane(GDEH0154D67_Base::PLANE_NEW);
+        if (shown == nullptr || !display_.isShadowPlaneValid(GDEH0154D67_Base::PLANE_NEW)) {
+            return false;
+        }
+        finishInflight();
+        memcpy(pending_, shown, sizeof(pending_));
+        dirty_count_ = 0;
+        return true;
+    }
+
+    /**
+     * @brief Post a full target frame
+     * @param frame 5000-byte frame (RAM or PROGMEM)
+     * @return false if committing failed
+     */
+    bool postFrame(const unsigned char* frame) {
+        FrameRect rects[MAX_RECTS];
+        unsigned int count = GDEH0154D67_Base::findDirtyRects(pending_, frame, rects, MAX_RECTS);
+        memcpy_P(pending_, frame, sizeof(pending_));
+        for (unsigned int i = 0; i < count; i++) {
+            markDirty(rects[i]);
+        }
+        return posted();
+    }
+
+    /**
+     * @brief Post new contents for one rectangle of the frame
+     * @param rect Frame rectangle (byte columns, rows)
+     * @param data rect.byteCount() bytes, top row first (RAM or PROGMEM)
+     * @return false if the rectangle is outside the frame or committing failed
+     */
+    bool postRect(const FrameRect& rect, const unsigned char* data) {
+        if (rect.x_start_byte > rect.x_end_byte || rect.x_end_byte >= LINE_BYTES ||
+            rect.row_start > rect.row_end || rect.row_end >= ROWS) {
+            return false;
+        }
+        unsigned int row_bytes = rect.x_end_byte - rect.x_start_byte + 1;
+        for (unsigned int row = rect.row_start; row <= rect.row_end; row++) {
+            memcpy_P(&pending_[row * LINE_BYTES + rect.x_start_byte], data, row_bytes);
+            data += row_bytes;
+        }
+        markDirty(rect);
+        return posted();
+    }
+
+    /**
+     * @brief Post face region patches (same data as updateFaceRegions())
+     * @return false if a patch is outside its region or committing failed
+     */
+    bool postFaceRegions(const FaceRegionPatch* patches, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            const FaceRegion& region = *patches[i].region;
+            const FrameRect& rect = patches[i].rect;
+            if (rect.x_start_byte < region.x_start_byte || rect.x_end_byte > region.x_end_byte ||
+                rect.row_start < region.row_start || rect.row_end > region.row_end ||
+                rect.x_start_byte > rect.x_end_byte || rect.row_start > rect.row_end) {
+                return false;
+            }
+            // Region images run bottom row first
+            unsigned int region_bytes = region.x_end_byte - region.x_start_byte + 1;
+            unsigned int row_bytes = rect.x_end_byte - rect.x_start_byte + 1;
+            for (unsigned int row = rect.row_start; row <= rect.row_end; row++) {
+                memcpy_P(&pending_[row * LINE_BYTES + rect.x_start_byte],
+                         patches[i].data + (region.row_end - row) * region_bytes + (rect.x_start_byte - region.x_start_byte),
+                         row_bytes);
+            }
+            markDirty(rect);
+        }
+        return posted();
+    }
+
+    /**
+     * @brief Commit the pending update if the panel is free (call from the main loop)
+     * @return false if committing failed
+     */
+    bool service() {
+        if (inflight_count_ > 0) {
+            if (!display_.isRefreshComplete(inflight_)) {
+                return true;  // Keep collecting
+            }
+            finishInflight();
+        }
+        if (dirty_count_ == 0) {
+            return true;
+        }
+
+        memcpy(inflight_rects_, dirty_, dirty_count_ * sizeof(FrameRect));
+        inflight_count_ = dirty_count_;
+        dirty_count_ = 0;
+        inflight_ = display_.updateFrameRectsAsync(pending_, inflight_rects_, inflight_count_);
+        if (!inflight_.isValid()) {
+            inflight_count_ = 0;
+            return false;
+        }
+        stats_.commits++;
+        return true;
+    }
+
+    /**
+     * @brief Wait until everything posted is on the panel
+     * @return false if committing failed
+     */
+    bool flush() {
+        while (inflight_count_ > 0 || dirty_count_ > 0) {
+            finishInflight();
+            if (!service()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check if posted content is not yet on the panel
+     */
+    bool isPending() const { return dirty_count_ > 0 || inflight_count_ > 0; }
+
+    /**
+     * @brief Newest target frame (what the panel will show after flush())
+     */
+    const unsigned char* pendingFrame() const { return pending_; }
+
+    /**
+     * @brief Counters since construction
+     */
+    const MailboxStats& stats() const { return stats_; }
+
+private:
+    Display& display_;                          ///< Driver the mailbox commits to
+    unsigned char pending_[LINE_BYTES * ROWS];  ///< Newest target frame
+    FrameRect dirty_[MAX_RECTS];                ///< Unioned rectangles not yet committed
+    unsigned int dirty_count_;                  ///< Entries in dirty_
+    FrameRect inflight_rects_[MAX_RECTS];       ///< Rectangles of the running refresh
+    unsigned int inflight_count_;               ///< Entries in inflight_rects_ (0 = idle)
+    RefreshHandle inflight_;                    ///< Running refresh
+    MailboxStats stats_;                        ///< Counters
+
+    void markDirty(const FrameRect& rect) {
+        dirty_count_ = GDEH0154D67_Base::addDirtyRect(dirty_, dirty_count_, MAX_RECTS, rect);
+    }
+
+    bool posted() {
+        stats_.posts++;
+        if (inflight_count_ > 0 && !display_.isRefreshComplete(inflight_)) {
+            stats_.merged++;
+            return true;
+        }
+        return service();
+    }
+
+    /**
+     * @brief Wait for the running refresh and bring RAM 0x26 up to date
+     */
+    void finishInflight() {
+        if (inflight_count_ == 0) {
+            return;
+        }
+        display_.syncOldPlane(inflight_rects_, inflight_count_);
+        inflight_count_ = 0;
+    }
+};
+
+#endif // GDEH0154D67_MAILBOX_H
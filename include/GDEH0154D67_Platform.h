@@ -0,0 +1,48 @@
+/**
+ * @file GDEH0154D67_Platform.h
+ * @brief Minimal platform layer shared by the firmware and host-side builds
+ *
+ * The display driver only needs a handful of Arduino facilities outside of the
+ * bus policy: PROGMEM access and a console for debug messages. On the ESP32
+ * these come from Arduino.h; on the host they map to the C standard library so
+ * the same driver code compiles against the simulated bus.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef GDEH0154D67_PLATFORM_H
+#define GDEH0154D67_PLATFORM_H
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+
+#else
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Host builds keep all data in ordinary memory
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_byte
+#define pgm_read_byte(addr) (*(const unsigned char*)(addr))
+#endif
+#ifndef memcpy_P
+#define memcpy_P memcpy
+#endif
+
+#endif // ARDUINO
+
+/**
+ * @brief Print one line to the debug console
+ * @param tag Prefix such as "[GDEH0154D67]"
+ * @param message Message text
+ */
+void platformLogLine(const char* tag, const char* message);
+
+#endif // GDEH0154D67_PLATFORM_H
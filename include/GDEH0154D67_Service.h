@@ -0,0 +1,350 @@
+/**
+ * @file GDEH0154D67_Service.h
+ * @brief Display service: one task owns the driver and executes queued commands
+ *
+ * A full refresh blocks for seconds, so the driver should not run inline in
+ * the application loop. GDEH0154D67_Service owns a driver instance and
+ * executes commands that other code pushes into a lock-free single-producer /
+ * single-consumer ring. On the ESP32 the consumer is a FreeRTOS task pinned to
+ * one core; on the host processPending() is called directly.
+ *
+ * push() never blocks: it fails (and counts the drop) when the ring is full.
+ * Commands may carry a coalescing key; a queued command is discarded when a
+ * newer command with the same key is already waiting behind it, so a producer
+ * that outruns the panel only ever costs the latest state.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#ifndef GDEH0154D67_SERVICE_H
+#define GDEH0154D67_SERVICE_H
+
+#include <atomic>
+
+#include "GDEH0154D67_Display.h"
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+/**
+ * @brief Lock-free ring for exactly one producer and one consumer
+ * @tparam T Trivially copyable element
+ * @tparam N Capacity, power of two
+ */
+template <typename T, size_t N>
+class GDEH0154D67_SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Ring capacity must be a power of two");
+
+public:
+    GDEH0154D67_SpscRing() : head_(0), tail_(0) {}
+
+    /**
+     * @brief Append an element (producer only)
+     * @return false if the ring is full
+     */
+    bool push(const T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+        items_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Number of queued elements (consumer only)
+     */
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Queued element by position, 0 = oldest (consumer only, index < size())
+     */
+    const T& peek(size_t index) const { return items_[(tail_.load(std::memory_order_relaxed) + index) & (N - 1)]; }
+
+    /**
+     * @brief Remove the oldest element (consumer only, size() > 0)
+     */
+    void pop() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    static constexpr size_t capacity() { return N; }
+
+private:
+    T items_[N];                     ///< Element storage
+    std::atomic<size_t> head_;       ///< Next slot to write, free running (producer)
+    std::atomic<size_t> tail_;       ///< Next slot to read, free running (consumer)
+};
+
+/**
+ * @brief Work item run on the display task by DisplayCommand::JOB
+ * @param context User pointer passed with the command
+ */
+typedef void (*DisplayJob)(void* context);
+
+/**
+ * @brief One queued display operation
+ */
+struct DisplayCommand {
+    enum Type : unsigned char {
+        SHOW_FRAME,         ///< updateFromFrame(data)
+        SHOW_ASSET,         ///< displayAsset(id)
+        FACE_REGIONS,       ///< updateFaceRegions(data, count)
+        APPLY_DELTA,        ///< applyFrameDelta(data)
+        REFRESH_FULL,       ///< refreshFull((FullRefreshMode)id) of the current RAM contents
+        JOB,                ///< job(data) on the display task
+        SLEEP               ///< enterDeepSleep()
+    };
+
+    Type type;
+    unsigned char coalesce_key;     ///< 0 = always executed, else dropped if a newer command shares the key
+    unsigned int id;                ///< Asset ID for SHOW_ASSET, FullRefreshMode for REFRESH_FULL
+    const void* data;               ///< Frame, patches, delta or job context
+    size_t count;                   ///< Patch count for FACE_REGIONS
+    DisplayJob job;                 ///< Function for JOB
+};
+
+/**
+ * @brief Counters of a GDEH0154D67_Service
+ */
+struct DisplayServiceStats {
+    unsigned long pushed;           ///< Commands accepted by push()
+    unsigned long rejected;         ///< Commands dropped because the ring was full
+    unsigned long coalesced;        ///< Commands skipped for a newer one with the same key
+    unsigned long executed;         ///< Commands run
+    unsigned long failed;           ///< Commands whose driver call reported an error
+};
+
+/**
+ * @brief Owns a display driver and executes commands from one producer
+ * @tparam Display Driver type, e.g. GDEH0154D67_Display
+ * @tparam QueueSize Ring capacity, power of two
+ *
+ * Only the service task may touch the driver once start() has been called.
+ * Data referenced by commands (frames, patches, deltas) must stay valid until
+ * the command has run; flash tables and generated patch lists always do.
+ */
+template <class Display, size_t QueueSize = 16>
+class GDEH0154D67_Service {
+public:
+    static constexpr unsigned char KEY_FRAME = 1;       ///< Default key of pushFrame(): only the newest frame matters
+    static constexpr unsigned char KEY_USER = 16;       ///< First key free for application use
+
+    explicit GDEH0154D67_Service(Display& display) : display_(display), stats_pushed_(0), stats_rejected_(0) {
+        memset(&stats_, 0, sizeof(stats_));
+#ifdef ARDUINO
+        task_ = nullptr;
+#endif
+    }
+
+    /**
+     * @brief Queue a command (producer side, never blocks)
+     * @return false if the ring is full; the command is dropped
+     */
+    bool push(const DisplayCommand& command) {
+        if (!queue_.push(command)) {
+            stats_rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        stats_pushed_.fetch_add(1, std::memory_order_relaxed);
+#ifdef ARDUINO
+        if (task_ != nullptr) {
+            xTaskNotifyGive(task_);
+        }
+#endif
+        return true;
+    }
+
+    /**
+     * @brief Queue a full frame, drawn with updateFromFrame() (only changed rows go out)
+     */
+    bool pushFrame(const unsigned char* frame, unsigned char coalesce_key = KEY_FRAME) {
+        return push(makeCommand(DisplayCommand::SHOW_FRAME, coalesce_key, 0, frame, 0, nullptr));
+    }
+
+    /**
+     * @brief Queue an asset from the pack (coalesce only screen-replacing assets)
+     */
+    bool pushAsset(unsigned int id, unsigned char coalesce_key = 0) {
+        return push(makeCommand(DisplayCommand::SHOW_ASSET, coalesce_key, id, nullptr, 0, nullptr));
+    }
+
+    /**
+     * @brief Queue face region patches, drawn with one partial refresh
+     */
+    bool pushFaceRegions(const FaceRegionPatch* patches, size_t count, unsigned char coalesce_key = 0) {
+        return push(makeCommand(DisplayCommand::FACE_REGIONS, coalesce_key, 0, patches, count, nullptr));
+    }
+
+    /**
+     * @brief Queue an XOR frame delta (never coalesced: deltas depend on their predecessor)
+     */
+    bool pushDelta(const unsigned char* delta) {
+        return push(makeCommand(DisplayCommand::APPLY_DELTA, 0, 0, delta, 0, nullptr));
+    }
+
+    /**
+     * @brief Queue a full refresh of the current RAM contents
+     */
+    bool pushRefreshFull(FullRefreshMode mode = FULL_REFRESH_NORMAL) {
+        return push(makeCommand(DisplayCommand::REFRESH_FULL, 0, mode, nullptr, 0, nullptr));
+    }
+
+    /**
+     * @brief Queue a function to run on the display task (e.g. an expression switch)
+     */
+    bool pushJob(DisplayJob job, void* context, unsigned char coalesce_key = 0) {
+        return push(makeCommand(DisplayCommand::JOB, coalesce_key, 0, context, 0, job));
+    }
+
+    /**
+     * @brief Queue deep sleep
+     */
+    bool pushSleep() {
+        return push(makeCommand(DisplayCommand::SLEEP, 0, 0, nullptr, 0, nullptr));
+    }
+
+    /**
+     * @brief Execute every queued command (consumer side)
+     * @return Number of commands executed
+     */
+    size_t processPending() {
+        size_t count = 0;
+        while (queue_.size() > 0) {
+            DisplayCommand command = queue_.peek(0);
+            bool superseded = command.coalesce_key != 0 && hasNewer(command.coalesce_key);
+            queue_.pop();
+
+            if (superseded) {
+                stats_.coalesced++;
+                continue;
+            }
+            if (!execute(command)) {
+                stats_.failed++;
+            }
+            stats_.executed++;
+            count++;
+        }
+        display_.poll();
+        return count;
+    }
+
+    /**
+     * @brief Counters (consumer-side fields are only exact when read from the service task)
+     */
+    DisplayServiceStats stats() const {
+        DisplayServiceStats stats = stats_;
+        stats.pushed = stats_pushed_.load(std::memory_order_relaxed);
+        stats.rejected = stats_rejected_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /**
+     * @brief Number of commands the ring can hold
+     */
+    static constexpr size_t queueCapacity() { return QueueSize; }
+
+    /**
+     * @brief Driver owned by the service (touch only from the service task)
+     */
+    Display& display() { return display_; }
+
+#ifdef ARDUINO
+    /**
+     * @brief Start the service task
+     * @param core Core to pin the task to (the Arduino loop runs on core 1)
+     * @param priority FreeRTOS priority
+     * @param stack_bytes Task stack size
+     * @return true if the task was created
+     */
+    bool start(BaseType_t core = 0, UBaseType_t priority = 2, uint32_t stack_bytes = 4096) {
+        if (task_ != nullptr) {
+            return true;
+        }
+        return xTaskCreatePinnedToCore(taskMain, "epd_service", stack_bytes, this, priority, &task_, core) == pdPASS;
+    }
+
+    /**
+     * @brief Check if the service task is running
+     */
+    bool isRunning() const { return task_ != nullptr; }
+#endif
+
+private:
+    Display& display_;                                      ///< Driver owned by the service
+    GDEH0154D67_SpscRing<DisplayCommand, QueueSize> queue_; ///< Pending commands
+    DisplayServiceStats stats_;                             ///< Consumer-side counters
+    std::atomic<unsigned long> stats_pushed_;               ///< Producer-side counter
+    std::atomic<unsigned long> stats_rejected_;             ///< Producer-side counter
+
+#ifdef ARDUINO
+    TaskHandle_t task_;                                     ///< Service task
+
+    static void taskMain(void* self) {
+        GDEH0154D67_Service* service = static_cast<GDEH0154D67_Service*>(self);
+        for (;;) {
+            service->processPending();
+            // Wake on the next push; time out to dispatch refresh callbacks
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+        }
+    }
+#endif
+
+    static DisplayCommand makeCommand(DisplayCommand::Type type, unsigned char key, unsigned int id,
+                                      const void* data, size_t count, DisplayJob job) {
+        DisplayCommand command;
+        command.type = type;
+        command.coalesce_key = key;
+        command.id = id;
+        command.data = data;
+        command.count = count;
+        command.job = job;
+        return command;
+    }
+
+    /**
+     * @brief Check if a command behind the oldest one shares its key
+     */
+    bool hasNewer(unsigned char key) const {
+        size_t queued = queue_.size();
+        for (size_t i = 1; i < queued; i++) {
+            if (queue_.peek(i).coalesce_key == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool execute(const DisplayCommand& command) {
+        switch (command.type) {
+        case DisplayCommand::SHOW_FRAME:
+            return display_.updateFromFrame(static_cast<const unsigned char*>(command.data));
+        case DisplayCommand::SHOW_ASSET:
+            return display_.displayAsset(command.id);
+        case DisplayCommand::FACE_REGIONS:
+            return display_.updateFaceRegions(static_cast<const FaceRegionPatch*>(command.data), command.count);
+        case DisplayCommand::APPLY_DELTA:
+            return display_.applyFrameDelta(static_cast<const unsigned char*>(command.data));
+        case DisplayCommand::REFRESH_FULL:
+            display_.refreshFull(static_cast<FullRefreshMode>(command.id));
+            return true;
+        case DisplayCommand::JOB:
+            if (command.job == nullptr) {
+                return false;
+            }
+            command.job(const_cast<void*>(command.data));
+            return true;
+        case DisplayCommand::SLEEP:
+            display_.enterDeepSleep();
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif // GDEH0154D67_SERVICE_H
@@ -0,0 +1,231 @@
+/**
+ * @file SSD1681_Emulator.h
+ * @brief Host-side SSD1681 command-stream emulator with a virtual 200x200 panel
+ *
+ * Attach an instance to a SimBus and the unmodified display driver runs on the
+ * host. The emulator models what matters for driver development:
+ *
+ * - RAM planes 0x24 (BW, "new") and 0x26 (RED, "old"), 25 x 200 bytes each
+ * - RAM windows (0x44/0x45), address counters (0x4E/0x4F) and the data entry
+ *   mode (0x11) including increment/decrement and window wrap-around
+ * - Custom LUT loads (0x32) and the update triggers (0x22 + 0x20)
+ * - Auto pattern fills (0x46 RED, 0x47 BW) over the RAM window: a checkerboard
+ *   of step width x step height cells starting at the window corner with the
+ *   first-step value; step codes 5 and up cover 200 (0xF7 = solid white,
+ *   0x77 = solid black)
+ * - BUSY timing in virtual milliseconds
+ *
+ * Panel update model (0x22 bits: 5 = load temperature from the sensor,
+ * 4 = load LUT from OTP, 3 = display mode 2):
+ * - Mode 1 with OTP LUT (0xF7):      panel = BW plane (full refresh)
+ * - Mode 2 (0xFF/0xCF):              pixels where BW != RED are driven to BW,
+ *                                    all others keep their current panel value
+ * - Mode 1 with custom LUT (0xC7):   4-gray, level = (!RED << 1) | !BW
+ *
+ * An OTP LUT loaded while the temperature register holds a value written with
+ * 0x1A of 80 degC or more (and not since reloaded from the sensor) is the
+ * short hot-temperature waveform: mode 1 refreshes with it take
+ * fast_full_refresh_ms.
+ *
+ * Mode 2 with a custom LUT (0xCF) lasts as long as the loaded waveform: the
+ * frames of all timing groups (phases A-D times their repeat counts) times
+ * lut_frame_us.
+ *
+ * The mode 2 rule reproduces ghosting when the RED plane is stale, which is what
+ * the driver has to get right for partial updates.
+ *
+ * Physical orientation follows the driver: panel row 0 is RAM Y 199 (the driver
+ * fills RAM bottom-up with Y decrement), bit 7 of a RAM byte is the leftmost pixel.
+ */
+
+#ifndef SSD1681_EMULATOR_H
+#define SSD1681_EMULATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "GDEH0154D67_Bus.h"
+
+class SSD1681Emulator : public SimBusDevice {
+public:
+    static constexpr int WIDTH = 200;          ///< Panel width in pixels
+    static constexpr int HEIGHT = 200;         ///< Panel height in pixels
+    static constexpr int RAM_X_BYTES = 25;     ///< RAM bytes per row
+    static constexpr int RAM_Y_ROWS = 200;     ///< RAM rows
+    static constexpr int LUT_SIZE = 153;       ///< Bytes loaded by 0x32
+    static constexpr int PLANE_BW = 0;         ///< Index of the 0x24 plane
+    static constexpr int PLANE_RED = 1;        ///< Index of the 0x26 plane
+
+    /**
+     * @brief Virtual BUSY durations in milliseconds
+     */
+    struct Timing {
+        unsigned long reset_ms;          ///< After SWRESET (0x12)
+        unsigned long full_refresh_ms;   ///< Mode 1 with OTP LUT
+        unsigned long fast_full_refresh_ms; ///< Mode 1 with the OTP LUT for a forced high temperature
+        unsigned long partial_refresh_ms; ///< Mode 2 with OTP LUT
+        unsigned long lut_frame_us;      ///< Frame period of a custom LUT in mode 2
+        unsigned long gray_refresh_ms;   ///< Mode 1 with custom LUT
+        unsigned long pattern_fill_ms;   ///< Auto pattern fill (0x46/0x47)
+    };
+
+    SSD1681Emulator();
+
+    // ===== SimBusDevice =====
+    void onCommand(uint8_t command) override;
+    void onData(const uint8_t* data, size_t length) override;
+    void onReset(bool active) override;
+    bool isBusy() override { return busy_remaining_ms_ > 0; }
+    void onDelay(unsigned long ms) override;
+
+    // ===== INSPECTION =====
+
+    /**
+     * @brief Read one RAM byte
+     * @param plane PLANE_BW or PLANE_RED
+     * @param x RAM X address (byte column, 0-24)
+     * @param y RAM Y address (0-199)
+     */
+    uint8_t ramByte(int plane, int x, int y) const { return ram_[plane][y][x]; }
+
+    /**
+     * @brief Copy a RAM plane in the driver's frame order (first row = RAM Y 199)
+     * @param plane PLANE_BW or PLANE_RED
+     * @param out 5000-byte destination
+     */
+    void copyPlaneAsFrame(int plane, uint8_t* out) const;
+
+    /**
+     * @brief Gray value of a panel pixel (0 = black, 255 = white)
+     */
+    uint8_t panelPixel(int x, int y) const { return panel_[y][x]; }
+
+    /**
+     * @brief Write the current panel image as binary PGM (P5)
+     * @return true on success
+     */
+    bool writePanelPgm(const char* path) const;
+
+    /**
+     * @brief Write one RAM plane as PGM in panel orientation
+     * @return true on success
+     */
+    bool writePlanePgm(int plane, const char* path) const;
+
+    // ===== COUNTERS & DIAGNOSTICS =====
+    unsigned long refreshCount() const { return refresh_count_; }
+    unsigned long hardwareResetCount() const { return hw_reset_count_; }
+    unsigned long lutLoadCount() const { return lut_load_count_; }
+    unsigned long errorCount() const { return error_count_; }
+    const char* lastError() const { return last_error_; }
+    bool customLutLoaded() const { return lut_source_ == LUT_CUSTOM; }
+    bool fastWaveformLoaded() const { return lut_source_ == LUT_OTP && lut_fast_; }
+    bool inDeepSleep() const { return deep_sleep_; }
+
+    /**
+     * @brief Number of argument bytes a command takes
+     * @return Argument count, -1 for streamed payloads (RAM writes), -2 if unknown
+     */
+    static constexpr int expectedArgCount(uint8_t command) {
+        switch (command) {
+            case 0x12:  // SWRESET
+            case 0x20:  // Master activation
+                return 0;
+            case 0x03:  // Gate driving voltage
+            case 0x10:  // Deep sleep
+            case 0x11:  // Data entry mode
+            case 0x18:  // Temperature sensor selection
+            case 0x22:  // Display update control 2
+            case 0x2C:  // VCOM
+            case 0x3C:  // Border waveform
+            case 0x3F:  // End option (EOPQ)
+            case 0x46:  // Auto write RED RAM pattern
+            case 0x47:  // Auto write BW RAM pattern
+            case 0x4E:  // RAM X counter
+            case 0x74:  // Analog block control
+            case 0x7E:  // Digital block control
+                return 1;
+            case 0x1A:  // Temperature register write
+            case 0x21:  // Display update control 1
+            case 0x44:  // RAM X window
+            case 0x4F:  // RAM Y counter
+                return 2;
+            case 0x01:  // Driver output control
+            case 0x04:  // Source driving voltage
+                return 3;
+            case 0x0C:  // Booster soft start
+            case 0x45:  // RAM Y window
+                return 4;
+            case 0x32:  // Write LUT register
+                return LUT_SIZE;
+            case 0x24:  // Write BW RAM
+            case 0x26:  // Write RED RAM
+                return -1;
+            default:
+                return -2;
+        }
+    }
+    
+    /**
+     * @brief Check a precompiled command table at compile time
+     * Every opcode must be known and carry exactly its argument count.
+     * @tparam Command Entry type with opcode and arg_count (e.g. InitCommand)
+     * @return true if every entry is valid
+     */
+    template <class Command, size_t N>
+    static constexpr bool validSequence(const Command (&sequence)[N]) {
+        for (size_t i = 0; i < N; i++) {
+            if (expectedArgCount(sequence[i].opcode) != sequence[i].arg_count) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Timing& timing() { return timing_; }
+
+private:
+    void resetRegisters();
+    void closeCommand();
+    void applyCommand();
+    void writeRam(uint8_t value);
+    void fillPattern(int plane, uint8_t pattern);
+    void activateUpdate();
+    unsigned long customLutFrames() const;
+    void setError(const char* error);
+
+    uint8_t ram_[2][RAM_Y_ROWS][RAM_X_BYTES]; ///< BW and RED RAM
+    uint8_t panel_[HEIGHT][WIDTH];             ///< What the panel currently shows
+    uint8_t lut_[LUT_SIZE];                    ///< Custom waveform from 0x32
+
+    // Controller registers
+    int x_start_, x_end_;       ///< RAM X window (bytes)
+    int y_start_, y_end_;       ///< RAM Y window
+    int x_counter_, y_counter_; ///< RAM address counters
+    uint8_t entry_mode_;        ///< Data entry mode (0x11)
+    uint8_t update_control_;    ///< Display update control 2 (0x22)
+    enum LutSource { LUT_NONE, LUT_OTP, LUT_CUSTOM };
+    LutSource lut_source_;      ///< Waveform currently in the LUT register
+    int temperature_c_;         ///< Temperature register, whole degrees
+    bool temperature_forced_;   ///< Register was written with 0x1A, not read from the sensor
+    bool lut_fast_;             ///< OTP LUT was selected for a forced high temperature
+
+    // Command parser
+    uint8_t command_;           ///< Current command
+    bool have_command_;         ///< A command is open and still accepts arguments
+    uint8_t args_[LUT_SIZE];    ///< Argument bytes of the current command
+    int arg_count_;             ///< Number of received arguments
+
+    // Timing & state
+    Timing timing_;
+    unsigned long busy_remaining_ms_;
+    bool in_reset_;
+    bool deep_sleep_;
+
+    unsigned long refresh_count_;
+    unsigned long hw_reset_count_;
+    unsigned long lut_load_count_;
+    unsigned long error_count_;
+    const char* last_error_;
+};
+
+#endif // SSD1681_EMULATOR_H
@@ -0,0 +1,67 @@
+/**
+ * @file SimBusCounter.h
+ * @brief SimBusDevice decorator that counts bus traffic for transport benchmarks
+ *
+ * Sits between a SimBus and the panel model and records what actually crosses
+ * the wire: command bytes per opcode, data bytes, CS assertions and the virtual
+ * time spent waiting. Wire time is estimated from those counts for any SPI clock.
+ */
+
+#ifndef SIM_BUS_COUNTER_H
+#define SIM_BUS_COUNTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "GDEH0154D67_Bus.h"
+
+/**
+ * @brief Traffic counted since the last reset
+ */
+struct BusStats {
+    unsigned long commands;        ///< Command bytes (DC low)
+    unsigned long data_bytes;      ///< Data bytes (DC high)
+    unsigned long cs_assertions;   ///< CS falling edges (one transaction each)
+    unsigned long resets;          ///< RST assertions
+    unsigned long wait_ms;         ///< Virtual time spent in driver delays
+    unsigned long opcode_counts[256]; ///< Command bytes per opcode
+
+    /** @brief CS edges (each assertion is followed by a release) */
+    unsigned long csToggles() const { return cs_assertions * 2; }
+
+    /**
+     * @brief Estimated time on the wire
+     * @param clock_hz SPI clock
+     * @param cs_overhead_us Fixed cost per CS transaction (setup/hold + software)
+     * @return Microseconds, excluding BUSY waits
+     */
+    double wireTimeUs(double clock_hz, double cs_overhead_us) const {
+        return (commands + data_bytes) * 8.0 * 1e6 / clock_hz + cs_assertions * cs_overhead_us;
+    }
+};
+
+class SimBusCounter : public SimBusDevice {
+public:
+    /**
+     * @param target Panel model that receives the forwarded traffic (may be nullptr)
+     */
+    explicit SimBusCounter(SimBusDevice* target = nullptr);
+
+    /** @brief Clear all counters */
+    void reset();
+
+    const BusStats& stats() const { return stats_; }
+
+    // ===== SimBusDevice =====
+    void onCommand(uint8_t command) override;
+    void onData(const uint8_t* data, size_t length) override;
+    void onChipSelect(bool active) override;
+    void onReset(bool active) override;
+    bool isBusy() override;
+    void onDelay(unsigned long ms) override;
+
+private:
+    SimBusDevice* target_;
+    BusStats stats_;
+};
+
+#endif // SIM_BUS_COUNTER_H
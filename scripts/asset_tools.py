@@ -0,0 +1,91 @@
+"""
+Shared helpers for the build-time asset scripts.
+
+Reads the 2bpp/1bpp image sources, splits 4-gray images into the SSD1681
+plane images and writes generated C headers only when their content changes.
+"""
+
+import os
+import re
+
+PLANE_BYTES = 5000
+GRAY_BYTES = 2 * PLANE_BYTES
+
+
+def read_header_array(path, name):
+    """Bytes of `const unsigned char name[...] = {...};` in a C header."""
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        text = f.read()
+    match = re.search(r"\b" + re.escape(name) + r"\s*\[[^\]]*\]\s*=\s*\{(.*?)\};", text, re.S)
+    if match is None:
+        raise ValueError("array %s not found in %s" % (name, path))
+    body = re.sub(r"/\*.*?\*/", "", match.group(1), flags=re.S)
+    return bytes(int(tok, 0) for tok in re.findall(r"0[xX][0-9a-fA-F]+|\d+", body))
+
+
+def read_source(project_dir, source, expected_length):
+    """
+    Load one asset source.
+    source is ("bin", path) or ("header", path, array_name), paths relative to project_dir.
+    Returns (data, description).
+    """
+    if source[0] == "bin":
+        with open(os.path.join(project_dir, source[1]), "rb") as f:
+            data = f.read()
+        origin = source[1]
+    else:
+        data = read_header_array(os.path.join(project_dir, source[1]), source[2])
+        origin = "%s (%s)" % (source[1], source[2])
+    if len(data) != expected_length:
+        raise ValueError("%s: expected %d bytes, got %d" % (origin, expected_length, len(data)))
+    return data, origin
+
+
+def split_planes(gray):
+    """Same result as ~convertGray2ToRam1 / ~convertGray2ToRam2 on each byte pair."""
+    plane_24 = bytearray(PLANE_BYTES)
+    plane_26 = bytearray(PLANE_BYTES)
+    for i in range(PLANE_BYTES):
+        ram1 = 0
+        ram2 = 0
+        for byte in (gray[2 * i], gray[2 * i + 1]):
+            for shift in (6, 4, 2, 0):
+                pixel = (byte >> shift) & 0x03
+                ram1 = (ram1 << 1) | (pixel & 0x01)
+                ram2 = (ram2 << 1) | (pixel >> 1)
+        plane_24[i] = ~ram1 & 0xFF
+        plane_26[i] = ~ram2 & 0xFF
+    return plane_24, plane_26
+
+
+def format_array(name, data):
+    lines = ["const unsigned char %s[%d] = {" % (name, len(data))]
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def write_if_changed(path, content, tag):
+    """Write a generated file unless it already holds exactly this content."""
+    if os.path.exists(path):
+        with open(path, "r", encoding="utf-8") as f:
+            if f.read() == content:
+                return False
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(content)
+    print("%s: wrote %s" % (tag, path))
+    return True
+
+
+def gray_to_mono(gray):
+    """1bpp frame (1 = white) from 2bpp data; gray levels 2 and 3 become white."""
+    mono = bytearray(PLANE_BYTES)
+    for i in range(PLANE_BYTES):
+        value = 0
+        for byte in (gray[2 * i], gray[2 * i + 1]):
+            for shift in (6, 4, 2, 0):
+                value = (value << 1) | ((byte >> shift) >> 1 & 0x01)
+        mono[i] = value
+    return bytes(mono)
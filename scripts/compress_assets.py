@@ -0,0 +1,185 @@
+"""
+Compress image assets into the container read by GDEH0154D67_AssetDecoder.
+
+Mono frames (gImage_basemap, gImage_1, gImage_2) are stored as the 0x24 plane,
+4-gray images as their pre-split 0x24 + 0x26 planes, so the driver streams the
+decoded bytes to controller RAM without further processing. Output goes to
+include/generated/compressed_assets.h; see include/GDEH0154D67_Asset.h for the
+container format.
+
+Runs as a PlatformIO pre: script (extra_scripts) or standalone:
+    python scripts/compress_assets.py [project_dir]
+"""
+
+import os
+import sys
+
+if __name__ == "__main__":
+    PROJECT_DIR = sys.argv[1] if len(sys.argv) > 1 else os.getcwd()
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+
+sys.path.insert(0, os.path.join(PROJECT_DIR, "scripts"))
+from asset_tools import (GRAY_BYTES, PLANE_BYTES, format_array, gray_to_mono, read_source,  # noqa: E402
+                         split_planes, write_if_changed)
+
+ASSET_MONO = 1
+ASSET_GRAY_PLANES = 2
+MONO_FROM_GRAY = "mono_from_gray"  # 2bpp source thresholded to a mono container
+
+WINDOW_SIZE = 256
+MIN_MATCH = 3
+MAX_MATCH = 0x7F + MIN_MATCH
+MAX_LITERAL = 0x80
+
+# (asset name, kind, source) - see asset_tools.read_source
+ASSETS = [
+    ("basemap", ASSET_MONO, ("header", "include/Ap_29demo.h", "gImage_basemap")),
+    ("image_1", ASSET_MONO, ("header", "include/Ap_29demo.h", "gImage_1")),
+    ("image_2", ASSET_MONO, ("header", "include/Ap_29demo.h", "gImage_2")),
+    ("gImage_11", ASSET_GRAY_PLANES, ("header", "include/Ap_29demo.h", "gImage_11")),
+    ("smile", ASSET_GRAY_PLANES, ("bin", "data/smile.bin")),
+    ("yawn", ASSET_GRAY_PLANES, ("bin", "data/yawn.bin")),
+    ("wincing", ASSET_GRAY_PLANES, ("bin", "data/wincing.bin")),
+    ("asleepSnoring", ASSET_GRAY_PLANES, ("bin", "data/asleepSnoring.bin")),
+    ("smilingMouthClosed", ASSET_GRAY_PLANES, ("bin", "data/smilingMouthClosed.bin")),
+    # Base frame for the partial-refresh face deltas (delta_assets.py)
+    ("face_smile", MONO_FROM_GRAY, ("bin", "data/smile.bin")),
+]
+
+OUTPUT = "include/generated/compressed_assets.h"
+
+
+def compress(data):
+    """Greedy LZ over a 256-byte window, emitting the token format of GDEH0154D67_Asset.h."""
+    out = bytearray()
+    literals = bytearray()
+    chains = {}  # 3-byte prefix -> positions, newest last
+    pos = 0
+    next_prune = 1024
+
+    def flush_literals():
+        for i in range(0, len(literals), MAX_LITERAL):
+            run = literals[i:i + MAX_LITERAL]
+            out.append(len(run) - 1)
+            out.extend(run)
+        del literals[:]
+
+    def remember(p):
+        if p + MIN_MATCH <= len(data):
+            chains.setdefault(bytes(data[p:p + MIN_MATCH]), []).append(p)
+
+    while pos < len(data):
+        best_length = 0
+        best_distance = 0
+        candidates = chains.get(bytes(data[pos:pos + MIN_MATCH]), [])
+        for start in reversed(candidates):
+            distance = pos - start
+            if distance > WINDOW_SIZE:
+                break
+            length = 0
+            # Overlapping matches are fine: the decoder copies byte by byte
+            while (length < MAX_MATCH and pos + length < len(data)
+                   and data[start + length] == data[pos + length]):
+                length += 1
+            if length > best_length:
+                best_length = length
+                best_distance = distance
+                if length == MAX_MATCH:
+                    break
+
+        if best_length >= MIN_MATCH:
+            flush_literals()
+            out.append(0x80 | (best_length - MIN_MATCH))
+            out.append(best_distance - 1)
+            for p in range(pos, pos + best_length):
+                remember(p)
+            pos += best_length
+        else:
+            literals.append(data[pos])
+            remember(pos)
+            pos += 1
+
+        # Drop chain entries that fell out of the window
+        if pos >= next_prune:
+            next_prune = pos + 1024
+            for key in list(chains):
+                kept = [p for p in chains[key] if pos - p <= WINDOW_SIZE]
+                if kept:
+                    chains[key] = kept
+                else:
+                    del chains[key]
+
+    flush_literals()
+    return bytes(out)
+
+
+def decompress(payload, raw_length):
+    """Reference decoder, used to check every container before it is emitted."""
+    out = bytearray()
+    pos = 0
+    while len(out) < raw_length:
+        token = payload[pos]
+        pos += 1
+        if token < 0x80:
+            out.extend(payload[pos:pos + token + 1])
+            pos += token + 1
+        else:
+            distance = payload[pos] + 1
+            pos += 1
+            for _ in range((token & 0x7F) + MIN_MATCH):
+                out.append(out[-distance])
+    return bytes(out)
+
+
+def container(kind, raw):
+    payload = compress(raw)
+    if decompress(payload, len(raw)) != raw:
+        raise RuntimeError("compressor round trip failed")
+    if len(raw) > 0xFFFF or len(payload) > 0xFFFF:
+        raise ValueError("asset too large for 16-bit container lengths")
+    header = bytes([ord("B"), ord("M"), ord("Z"), kind,
+                    len(raw) & 0xFF, len(raw) >> 8, len(payload) & 0xFF, len(payload) >> 8])
+    return header + payload
+
+
+def generate(project_dir):
+    parts = [
+        "/**",
+        " * @file compressed_assets.h",
+        " * @brief Compressed image containers, generated by scripts/compress_assets.py",
+        " *",
+        " * Do not edit: regenerated from the image sources by the build.",
+        " * Pass an asset to GDEH0154D67::displayCompressedImage().",
+        " */",
+        "",
+        "#pragma once",
+        "",
+    ]
+    total_raw = 0
+    total_packed = 0
+    for name, kind, source in ASSETS:
+        if kind == ASSET_MONO:
+            raw, origin = read_source(project_dir, source, PLANE_BYTES)
+        elif kind == MONO_FROM_GRAY:
+            gray, origin = read_source(project_dir, source, GRAY_BYTES)
+            raw = gray_to_mono(gray)
+            kind = ASSET_MONO
+        else:
+            gray, origin = read_source(project_dir, source, GRAY_BYTES)
+            plane_24, plane_26 = split_planes(gray)
+            raw = bytes(plane_24 + plane_26)
+        packed = container(kind, raw)
+        total_raw += len(raw)
+        total_packed += len(packed)
+        parts.append("// %s: %d -> %d bytes" % (origin, len(raw), len(packed)))
+        parts.append(format_array("asset_%s" % name, packed))
+        parts.append("")
+
+    parts.append("// Total: %d -> %d bytes" % (total_raw, total_packed))
+    parts.append("")
+    write_if_changed(os.path.join(project_dir, OUTPUT), "\n".join(parts), "compress_assets")
+
+
+generate(PROJECT_DIR)
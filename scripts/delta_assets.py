@@ -0,0 +1,165 @@
+"""
+Encode face animation frames as sparse XOR deltas for GDEH0154D67::applyFrameDelta().
+
+Each expression face in data/ is thresholded to 1bpp (gray levels 2-3 = white)
+and every transition in TRANSITIONS is stored as row-span records covering only
+the bytes that change. A record is a byte-aligned frame rectangle followed by
+its XOR bytes in RAM stream order (bottom row first, as the partial path
+uploads them), so both the asset and the upload scale with the changed area.
+The base face itself is stored by compress_assets.py as asset_face_<name>.
+
+Delta layout (little endian):
+    [0..2] 'B' 'M' 'D'
+    [3]    record count
+    [4..5] payload length (bytes after this header)
+    records: x_start_byte, x_end_byte, row_start, row_end, then XOR bytes
+
+Runs as a PlatformIO pre: script (extra_scripts) or standalone:
+    python scripts/delta_assets.py [project_dir]
+"""
+
+import os
+import sys
+
+if __name__ == "__main__":
+    PROJECT_DIR = sys.argv[1] if len(sys.argv) > 1 else os.getcwd()
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+
+sys.path.insert(0, os.path.join(PROJECT_DIR, "scripts"))
+from asset_tools import GRAY_BYTES, format_array, gray_to_mono, read_source, write_if_changed  # noqa: E402
+
+LINE_BYTES = 25
+HEIGHT = 200
+MAX_RECORDS = 16        # Same budget as the driver's dirty-rectangle search
+RECORD_OVERHEAD = 18    # Record header + RAM window setup, in byte equivalents
+SPAN_GAP = 2            # Unchanged bytes bridged inside one row span
+
+FACES = ["smile", "yawn", "wincing", "smilingMouthClosed", "asleepSnoring"]
+
+# Every face returns to the smile, so deltas can be played from the base in any order
+TRANSITIONS = [("smile", face) for face in FACES[1:]] + [(face, "smile") for face in FACES[1:]]
+
+OUTPUT = "include/generated/face_deltas.h"
+
+
+def area(rect):
+    x0, x1, r0, r1 = rect
+    return (x1 - x0 + 1) * (r1 - r0 + 1)
+
+
+def union(a, b):
+    return (min(a[0], b[0]), max(a[1], b[1]), min(a[2], b[2]), max(a[3], b[3]))
+
+
+def overlaps(a, b):
+    return a[0] <= b[1] and b[0] <= a[1] and a[2] <= b[3] and b[2] <= a[3]
+
+
+def row_spans(diff, row):
+    spans = []
+    line = diff[row * LINE_BYTES:(row + 1) * LINE_BYTES]
+    for x, value in enumerate(line):
+        if value == 0:
+            continue
+        if spans and x - spans[-1][1] <= SPAN_GAP + 1:
+            spans[-1][1] = x
+        else:
+            spans.append([x, x])
+    return spans
+
+
+def dirty_rects(diff):
+    """Rectangles (x_start_byte, x_end_byte, row_start, row_end) covering every non-zero byte."""
+    closed = []
+    open_rects = []
+    for row in range(HEIGHT):
+        grown = []
+        for x0, x1 in row_spans(diff, row):
+            touching = [r for r in open_rects if r[0] <= x1 + 1 and x0 <= r[1] + 1]
+            rect = (x0, x1, row, row)
+            for r in touching:
+                open_rects.remove(r)
+                rect = union(rect, r)
+            grown.append(rect)
+        closed.extend(open_rects)
+        open_rects = grown
+    rects = closed + open_rects
+
+    # Merge while it pays off or the record budget is exceeded; records must never
+    # overlap, because XOR applied twice cancels
+    while len(rects) > 1:
+        best = None
+        for i in range(len(rects)):
+            for j in range(i + 1, len(rects)):
+                merged = union(rects[i], rects[j])
+                extra = area(merged) - area(rects[i]) - area(rects[j])
+                if overlaps(rects[i], rects[j]):
+                    extra = -1 << 20
+                if best is None or extra < best[0]:
+                    best = (extra, i, j, merged)
+        if best[0] > RECORD_OVERHEAD and len(rects) <= MAX_RECORDS:
+            break
+        _, i, j, merged = best
+        rects = [r for k, r in enumerate(rects) if k not in (i, j)] + [merged]
+    return sorted(rects, key=lambda r: (r[2], r[0]))
+
+
+def encode_delta(old, new):
+    diff = bytes(a ^ b for a, b in zip(old, new))
+    rects = dirty_rects(diff)
+    payload = bytearray()
+    for x0, x1, r0, r1 in rects:
+        payload.extend((x0, x1, r0, r1))
+        for row in range(r1, r0 - 1, -1):
+            payload.extend(diff[row * LINE_BYTES + x0:row * LINE_BYTES + x1 + 1])
+
+    # Round trip: the records must reproduce the target exactly
+    check = bytearray(old)
+    pos = 0
+    for _ in rects:
+        x0, x1, r0, r1 = payload[pos:pos + 4]
+        pos += 4
+        for row in range(r1, r0 - 1, -1):
+            for x in range(x0, x1 + 1):
+                check[row * LINE_BYTES + x] ^= payload[pos]
+                pos += 1
+    if bytes(check) != bytes(new):
+        raise RuntimeError("delta round trip failed")
+
+    if len(payload) > 0xFFFF:
+        raise ValueError("delta payload too large")
+    return bytes([ord("B"), ord("M"), ord("D"), len(rects),
+                  len(payload) & 0xFF, len(payload) >> 8]) + bytes(payload), len(rects)
+
+
+def generate(project_dir):
+    frames = {}
+    for face in FACES:
+        gray, _ = read_source(project_dir, ("bin", "data/%s.bin" % face), GRAY_BYTES)
+        frames[face] = gray_to_mono(gray)
+
+    parts = [
+        "/**",
+        " * @file face_deltas.h",
+        " * @brief XOR deltas between BMO faces, generated by scripts/delta_assets.py",
+        " *",
+        " * Do not edit: regenerated from the face images in data/ by the build.",
+        " * Show asset_face_smile first, then pass deltas to GDEH0154D67::applyFrameDelta()",
+        " * in an order that matches what the panel shows.",
+        " */",
+        "",
+        "#pragma once",
+        "",
+    ]
+    for old, new in TRANSITIONS:
+        delta, records = encode_delta(frames[old], frames[new])
+        parts.append("// %s -> %s: %d records, %d bytes" % (old, new, records, len(delta)))
+        parts.append(format_array("delta_%s_to_%s" % (old, new), delta))
+        parts.append("")
+
+    write_if_changed(os.path.join(project_dir, OUTPUT), "\n".join(parts), "delta_assets")
+
+
+generate(PROJECT_DIR)
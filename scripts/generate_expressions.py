@@ -0,0 +1,279 @@
+"""
+Build the expression tables for BmoExpressionEngine from data/bmo_expressions.json.
+
+Every expression names, per dynamic region, the face image its pixels come
+from. The script crops those regions (1bpp, gray levels 2-3 = white), stores
+each distinct crop once and precomputes, for every (from, to) pair, the
+regions that change and the tightest byte rectangle inside each that differs.
+Switching expressions then uploads only those rectangles, with one refresh.
+
+The "animations" section adds keyframes to the animation_sequences of
+data/bmo_face_regions.json for BmoTimelinePlayer.
+
+Outputs:
+    include/generated/bmo_expressions.h        BmoExpression enum (include anywhere)
+    include/generated/bmo_expression_tables.h  crops and plans (included by src/BMO_Expressions.cpp only)
+
+Runs after generate_regions_header.py as a PlatformIO pre: script, or standalone:
+    python scripts/generate_expressions.py [project_dir]
+"""
+
+import json
+import os
+import re
+import sys
+
+if __name__ == "__main__":
+    PROJECT_DIR = sys.argv[1] if len(sys.argv) > 1 else os.getcwd()
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+
+sys.path.insert(0, os.path.join(PROJECT_DIR, "scripts"))
+from asset_tools import GRAY_BYTES, format_array, gray_to_mono, read_source, write_if_changed  # noqa: E402
+
+EXPRESSIONS = "data/bmo_expressions.json"
+REGIONS = "data/bmo_face_regions.json"
+ENUM_OUTPUT = "include/generated/bmo_expressions.h"
+TABLES_OUTPUT = "include/generated/bmo_expression_tables.h"
+LINE_BYTES = 25
+
+
+def identifier(key):
+    return re.sub(r"[^A-Za-z0-9]+", "_", key).upper()
+
+
+def crop(frame, region):
+    """Region bytes, bottom row first (the order FaceRegion images use)."""
+    x0, x1, r0, r1 = region
+    return bytes(frame[row * LINE_BYTES + x] for row in range(r1, r0 - 1, -1) for x in range(x0, x1 + 1))
+
+
+def diff_rect(region, old, new):
+    """Tightest (x0, x1, r0, r1) inside region where two crops differ, or None."""
+    x0, x1, r0, r1 = region
+    width = x1 - x0 + 1
+    changed = [(i % width, i // width) for i in range(len(old)) if old[i] != new[i]]
+    if not changed:
+        return None
+    xs = [c[0] for c in changed]
+    ys = [c[1] for c in changed]  # 0 = bottom row (r1)
+    return (x0 + min(xs), x0 + max(xs), r1 - max(ys), r1 - min(ys))
+
+
+def area(rect):
+    return (rect[1] - rect[0] + 1) * (rect[3] - rect[2] + 1)
+
+
+def overlaps(a, b):
+    return a[0] <= b[1] and b[0] <= a[1] and a[2] <= b[3] and b[2] <= a[3]
+
+
+def generate(project_dir):
+    with open(os.path.join(project_dir, EXPRESSIONS), "r", encoding="utf-8") as f:
+        spec = json.load(f)
+    with open(os.path.join(project_dir, REGIONS), "r", encoding="utf-8") as f:
+        region_spec = json.load(f)["regions"]
+
+    faces = {}
+    for name, path in spec["faces"].items():
+        gray, _ = read_source(project_dir, ("bin", path), GRAY_BYTES)
+        faces[name] = gray_to_mono(gray)
+
+    region_keys = spec["regions"]
+    regions = {}
+    for key in region_keys:
+        r = region_spec[key]
+        regions[key] = (int(r["x_start_byte"]), int(r["x_end_byte"]), int(r["y_start"]), int(r["y_end"]))
+    for i, a in enumerate(region_keys):
+        for b in region_keys[i + 1:]:
+            if overlaps(regions[a], regions[b]):
+                raise ValueError("expression regions %s and %s overlap" % (a, b))
+
+    names = list(spec["expressions"])
+    if spec.get("initial", names[0]) not in names:
+        raise ValueError("initial expression %s is not defined" % spec["initial"])
+
+    with open(os.path.join(project_dir, REGIONS), "r", encoding="utf-8") as f:
+        sequences = json.load(f).get("animation_sequences", {})
+    animations = spec.get("animations", {})
+
+    # Crop per (expression, region), stored once per distinct content
+    images = []           # (region key, bytes, sources)
+    image_index = {}      # (region key, bytes) -> index
+    expression_images = {}
+    for name in names:
+        expression = spec["expressions"][name]
+        for key in region_keys:
+            face = expression.get("regions", {}).get(key, expression["face"])
+            if face not in faces:
+                raise ValueError("expression %s uses unknown face %s" % (name, face))
+            data = crop(faces[face], regions[key])
+            if (key, data) not in image_index:
+                image_index[(key, data)] = len(images)
+                images.append((key, data, []))
+            index = image_index[(key, data)]
+            if face not in images[index][2]:
+                images[index][2].append(face)
+            expression_images[(name, key)] = index
+
+    for key, animation in animations.items():
+        if key not in sequences:
+            raise ValueError("animation %s has no entry in animation_sequences" % key)
+        frames = animation["frames"]
+        period = int(animation.get("period_ms", 0))
+        if not frames:
+            raise ValueError("animation %s has no frames" % key)
+        for at, name in frames:
+            if name not in names:
+                raise ValueError("animation %s uses unknown expression %s" % (key, name))
+        times = [int(at) for at, _ in frames]
+        if times[0] != 0 or any(b <= a for a, b in zip(times, times[1:])):
+            raise ValueError("animation %s: frames must start at 0 ms and strictly increase" % key)
+        if times[-1] > int(sequences[key]["duration_ms"]):
+            raise ValueError("animation %s: last frame is after duration_ms" % key)
+        if period and period <= times[-1]:
+            raise ValueError("animation %s: period_ms must exceed the last frame" % key)
+        steps = list(zip(frames, frames[1:])) + ([(frames[-1], frames[0])] if period else [])
+        for (_, a), (_, b) in steps:
+            for region in region_keys:
+                if expression_images[(a, region)] != expression_images[(b, region)] and \
+                        region not in sequences[key]["regions"]:
+                    raise ValueError("animation %s: %s -> %s changes %s, not in the sequence regions"
+                                     % (key, a, b, region))
+
+    # ===== ENUM HEADER =====
+    enum = [
+        "/**",
+        " * @file bmo_expressions.h",
+        " * @brief BMO expression IDs from %s, generated by scripts/generate_expressions.py" % EXPRESSIONS,
+        " *",
+        " * Do not edit: regenerated from the JSON by the build.",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        "enum BmoExpression : unsigned char {",
+    ]
+    for name in names:
+        enum.append("    BMO_EXPRESSION_%s," % identifier(name))
+    enum.append("    BMO_EXPRESSION_COUNT")
+    enum.append("};")
+    enum.append("")
+    enum.append("constexpr BmoExpression BMO_EXPRESSION_INITIAL = BMO_EXPRESSION_%s;"
+                % identifier(spec.get("initial", names[0])))
+    enum.append("")
+    enum.append("enum BmoAnimation : unsigned char {")
+    for key in animations:
+        enum.append("    BMO_ANIMATION_%s," % identifier(key))
+    enum.append("    BMO_ANIMATION_COUNT")
+    enum.append("};")
+    enum.append("")
+
+    # ===== TABLES HEADER =====
+    tables = [
+        "/**",
+        " * @file bmo_expression_tables.h",
+        " * @brief Region images and transition plans, generated by scripts/generate_expressions.py",
+        " *",
+        " * Do not edit: regenerated from %s by the build." % EXPRESSIONS,
+        " * Included only by src/BMO_Expressions.cpp so the data exists once in flash.",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        '#include "BMO_Face.h"',
+        '#include "bmo_face_regions.h"',
+        '#include "bmo_expressions.h"',
+        "",
+        "// ===== REGION IMAGES =====",
+        "",
+    ]
+    for index, (key, data, sources) in enumerate(images):
+        tables.append("// %s from %s" % (key, ", ".join(sources)))
+        tables.append(format_array("BMO_REGION_IMAGE_%d" % index, data))
+        tables.append("")
+
+    def patch(key, index, rect):
+        return ("    { &BMO_FACE_%s, BMO_REGION_IMAGE_%d, FrameRect(%d, %d, %d, %d) },"
+                % (identifier(key), index, rect[0], rect[1], rect[2], rect[3]))
+
+    tables.append("// ===== FULL EXPRESSIONS =====")
+    tables.append("")
+    tables.append("constexpr const char* BMO_EXPRESSION_NAMES[BMO_EXPRESSION_COUNT] = {")
+    for name in names:
+        tables.append('    "%s",' % name)
+    tables.append("};")
+    tables.append("")
+    tables.append("constexpr FaceRegionPatch BMO_EXPRESSION_PATCHES[] = {")
+    full_lists = []
+    for name in names:
+        start = len(full_lists) * len(region_keys)
+        tables.append("    // %s" % name)
+        for key in region_keys:
+            tables.append(patch(key, expression_images[(name, key)], regions[key]))
+        full_lists.append((start, len(region_keys), sum(area(regions[k]) for k in region_keys)))
+    tables.append("};")
+    tables.append("")
+    tables.append("constexpr FacePatchList BMO_EXPRESSION_FULL[BMO_EXPRESSION_COUNT] = {")
+    for name, (start, count, size) in zip(names, full_lists):
+        tables.append("    { &BMO_EXPRESSION_PATCHES[%d], %d, %d },  // %s" % (start, count, size, name))
+    tables.append("};")
+    tables.append("")
+
+    tables.append("// ===== TRANSITIONS =====")
+    tables.append("")
+    transition_patches = []
+    plans = {}
+    for old in names:
+        for new in names:
+            start = len(transition_patches)
+            size = 0
+            for key in region_keys:
+                old_index = expression_images[(old, key)]
+                new_index = expression_images[(new, key)]
+                if old_index == new_index:
+                    continue
+                rect = diff_rect(regions[key], images[old_index][1], images[new_index][1])
+                transition_patches.append((old, new, key, new_index, rect))
+                size += area(rect)
+            plans[(old, new)] = (start, len(transition_patches) - start, size)
+
+    tables.append("constexpr FaceRegionPatch BMO_TRANSITION_PATCHES[] = {")
+    for old, new, key, index, rect in transition_patches:
+        tables.append(patch(key, index, rect) + "  // %s -> %s" % (old, new))
+    if not transition_patches:
+        tables.append("    { nullptr, nullptr, FrameRect() },  // unused")
+    tables.append("};")
+    tables.append("")
+    tables.append("constexpr FacePatchList BMO_TRANSITIONS[BMO_EXPRESSION_COUNT][BMO_EXPRESSION_COUNT] = {")
+    for old in names:
+        tables.append("    {   // from %s" % old)
+        for new in names:
+            start, count, size = plans[(old, new)]
+            pointer = "&BMO_TRANSITION_PATCHES[%d]" % start if count else "nullptr"
+            tables.append("        { %s, %d, %d },  // -> %s" % (pointer, count, size, new))
+        tables.append("    },")
+    tables.append("};")
+    tables.append("")
+
+    tables.append("// ===== ANIMATION TIMELINES =====")
+    tables.append("")
+    for key, animation in animations.items():
+        frames = ", ".join("{ %d, BMO_EXPRESSION_%s }" % (int(at), identifier(name))
+                           for at, name in animation["frames"])
+        tables.append("constexpr FaceKeyframe BMO_TIMELINE_%s_FRAMES[] = { %s };" % (identifier(key), frames))
+    tables.append("")
+    tables.append("constexpr FaceTimeline BMO_TIMELINES[BMO_ANIMATION_COUNT + 1] = {")
+    for key, animation in animations.items():
+        tables.append("    { &BMO_SEQUENCE_%s, BMO_TIMELINE_%s_FRAMES, %d, %d },"
+                      % (identifier(key), identifier(key), len(animation["frames"]), int(animation.get("period_ms", 0))))
+    tables.append("    { nullptr, nullptr, 0, 0 },  // end marker")
+    tables.append("};")
+    tables.append("")
+
+    write_if_changed(os.path.join(project_dir, ENUM_OUTPUT), "\n".join(enum), "generate_expressions")
+    write_if_changed(os.path.join(project_dir, TABLES_OUTPUT), "\n".join(tables), "generate_expressions")
+
+
+generate(PROJECT_DIR)
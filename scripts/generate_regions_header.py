@@ -0,0 +1,135 @@
+"""
+Generate compile-time face region descriptors from data/bmo_face_regions.json.
+
+Each region becomes a constexpr FaceRegion holding its byte/row bounds, the
+precomputed argument bytes for 0x44/0x45/0x4E/0x4F (RAM Y = 199 - row, the
+addressing the partial path uses) and its refresh strategy. Every descriptor
+is checked with static_assert, so a region outside the panel fails the build.
+animation_sequences become FaceAnimationSequence tables.
+
+Output: include/generated/bmo_face_regions.h
+
+Runs as a PlatformIO pre: script (extra_scripts) or standalone:
+    python scripts/generate_regions_header.py [project_dir]
+"""
+
+import json
+import os
+import re
+import sys
+
+if __name__ == "__main__":
+    PROJECT_DIR = sys.argv[1] if len(sys.argv) > 1 else os.getcwd()
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+
+sys.path.insert(0, os.path.join(PROJECT_DIR, "scripts"))
+from asset_tools import write_if_changed  # noqa: E402
+
+SOURCE = "data/bmo_face_regions.json"
+OUTPUT = "include/generated/bmo_face_regions.h"
+
+HEIGHT = 200
+LINE_BYTES = 25
+PRIORITIES = {"low": 0, "medium": 1, "high": 2}
+DEFAULT_UPDATE_MODE = 0xFF  # Plain partial refresh
+
+
+def identifier(key):
+    return re.sub(r"[^A-Za-z0-9]+", "_", key).upper()
+
+
+def region_name(key):
+    return "BMO_FACE_%s" % identifier(key)
+
+
+def generate(project_dir):
+    with open(os.path.join(project_dir, SOURCE), "r", encoding="utf-8") as f:
+        spec = json.load(f)
+
+    strategies = {}
+    for strategy in spec.get("refresh_strategies", {}).values():
+        for key in strategy["regions"]:
+            strategies[key] = (int(strategy["update_mode"], 0), int(strategy["ghosting_threshold"]))
+
+    parts = [
+        "/**",
+        " * @file bmo_face_regions.h",
+        " * @brief Face regions from %s, generated by scripts/generate_regions_header.py" % SOURCE,
+        " *",
+        " * Do not edit: regenerated from the JSON by the build.",
+        " * Pass a region to GDEH0154D67::updateFaceRegion().",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        '#include "BMO_Face.h"',
+        "",
+        "// ===== REGIONS =====",
+        "",
+    ]
+
+    regions = spec["regions"]
+    for key, region in regions.items():
+        x0 = int(region["x_start_byte"])
+        x1 = int(region["x_end_byte"])
+        r0 = int(region["y_start"])
+        r1 = int(region["y_end"])
+        if not (0 <= x0 <= x1 < LINE_BYTES and 0 <= r0 <= r1 < HEIGHT):
+            raise ValueError("region %s is outside the panel" % key)
+        y_first = HEIGHT - 1 - r1
+        y_last = HEIGHT - 1 - r0
+        update_mode, threshold = strategies.get(key, (DEFAULT_UPDATE_MODE, 0))
+        name = region_name(key)
+        parts.append("// %s: bytes %d-%d, rows %d-%d" % (region.get("name", key), x0, x1, r0, r1))
+        parts.append("constexpr FaceRegion %s = {" % name)
+        parts.append('    "%s", %d, %d, %d, %d,' % (key, x0, x1, r0, r1))
+        window_lines = [
+            ("    { 0x%02X, 0x%02X }," % (x0, x1), "0x44 RAM X window"),
+            ("    { 0x%02X, 0x%02X, 0x%02X, 0x%02X }," % (y_first % 256, y_first // 256, y_last % 256, y_last // 256),
+             "0x45 RAM Y window"),
+            ("    0x%02X," % x0, "0x4E RAM X counter"),
+            ("    { 0x%02X, 0x%02X }," % (y_first % 256, y_first // 256), "0x4F RAM Y counter"),
+        ]
+        for code, comment in window_lines:
+            parts.append("%s// %s" % (code.ljust(36), comment))
+        parts.append("    %d, 0x%02X, %d" % (PRIORITIES.get(region.get("priority", "low"), 0), update_mode, threshold))
+        parts.append("};")
+        parts.append('static_assert(%s.isValid(), "%s: region outside the panel or window bytes inconsistent");'
+                     % (name, key))
+        parts.append("")
+
+    parts.append("constexpr const FaceRegion* BMO_FACE_REGIONS[] = {")
+    for key in regions:
+        parts.append("    &%s," % region_name(key))
+    parts.append("};")
+    parts.append("constexpr unsigned int BMO_FACE_REGION_COUNT = %d;" % len(regions))
+    parts.append("")
+
+    parts.append("// ===== ANIMATION SEQUENCES =====")
+    parts.append("")
+    sequences = spec.get("animation_sequences", {})
+    for key, sequence in sequences.items():
+        for member in sequence["regions"]:
+            if member not in regions:
+                raise ValueError("sequence %s references unknown region %s" % (key, member))
+        name = "BMO_SEQUENCE_%s" % identifier(key)
+        parts.append("constexpr const FaceRegion* %s_REGIONS[] = { %s };"
+                     % (name, ", ".join("&%s" % region_name(m) for m in sequence["regions"])))
+        parts.append('constexpr FaceAnimationSequence %s = { "%s", %s_REGIONS, %d, %d, "%s" };'
+                     % (name, key, name, len(sequence["regions"]), int(sequence["duration_ms"]),
+                        sequence.get("frequency", "")))
+        parts.append("")
+
+    parts.append("constexpr const FaceAnimationSequence* BMO_ANIMATION_SEQUENCES[] = {")
+    for key in sequences:
+        parts.append("    &BMO_SEQUENCE_%s," % identifier(key))
+    parts.append("};")
+    parts.append("constexpr unsigned int BMO_ANIMATION_SEQUENCE_COUNT = %d;" % len(sequences))
+    parts.append("")
+
+    write_if_changed(os.path.join(project_dir, OUTPUT), "\n".join(parts), "generate_regions_header")
+
+
+generate(PROJECT_DIR)
@@ -0,0 +1,147 @@
+"""
+Build the indexed asset pack for the "assets" flash partition.
+
+Collects the generated image data (compressed containers, face deltas and
+pre-split gray planes from include/generated/) into one pack file that the
+firmware maps zero-copy with esp_partition_mmap() and the host build maps with
+mmap(). See include/GDEH0154D67_AssetPack.h for the layout.
+
+Outputs:
+    .pio/assets/assets.bin            pack image for partition "assets"
+    include/generated/asset_ids.h     ASSET_ID_* constants
+
+IDs are fixed in PACK below so a reflashed pack stays compatible with firmware
+built against an older asset_ids.h; append new assets with new IDs.
+
+Runs after the other asset scripts as a PlatformIO pre: script, or standalone:
+    python scripts/pack_assets.py [project_dir]
+Under PlatformIO it also adds an "upload_assets" target that writes the pack
+to the partition offset from partitions_assets.csv.
+"""
+
+import os
+import re
+import struct
+import sys
+
+if __name__ == "__main__":
+    PROJECT_DIR = sys.argv[1] if len(sys.argv) > 1 else os.getcwd()
+    ENV = None
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    ENV = env  # noqa: F821
+    PROJECT_DIR = ENV.subst("$PROJECT_DIR")
+
+sys.path.insert(0, os.path.join(PROJECT_DIR, "scripts"))
+from asset_tools import read_header_array, write_if_changed  # noqa: E402
+
+KIND_MONO = 1
+KIND_GRAY_PLANES = 2
+KIND_COMPRESSED = 3
+KIND_DELTA = 4
+
+COMPRESSED = "include/generated/compressed_assets.h"
+DELTAS = "include/generated/face_deltas.h"
+PLANES = "include/generated/gray_planes.h"
+
+# (id, name, kind, header, arrays concatenated into the blob)
+PACK = [
+    (1, "BASEMAP", KIND_COMPRESSED, COMPRESSED, ["asset_basemap"]),
+    (2, "IMAGE_1", KIND_COMPRESSED, COMPRESSED, ["asset_image_1"]),
+    (3, "IMAGE_2", KIND_COMPRESSED, COMPRESSED, ["asset_image_2"]),
+    (4, "GRAY_DEMO", KIND_COMPRESSED, COMPRESSED, ["asset_gImage_11"]),
+    (5, "FACE_SMILE", KIND_COMPRESSED, COMPRESSED, ["asset_face_smile"]),
+    (10, "SMILE", KIND_GRAY_PLANES, PLANES, ["gray_planes_smile_24", "gray_planes_smile_26"]),
+    (11, "YAWN", KIND_GRAY_PLANES, PLANES, ["gray_planes_yawn_24", "gray_planes_yawn_26"]),
+    (12, "WINCING", KIND_GRAY_PLANES, PLANES, ["gray_planes_wincing_24", "gray_planes_wincing_26"]),
+    (13, "ASLEEP_SNORING", KIND_GRAY_PLANES, PLANES,
+     ["gray_planes_asleepSnoring_24", "gray_planes_asleepSnoring_26"]),
+    (14, "SMILING_MOUTH_CLOSED", KIND_GRAY_PLANES, PLANES,
+     ["gray_planes_smilingMouthClosed_24", "gray_planes_smilingMouthClosed_26"]),
+    (20, "DELTA_SMILE_TO_YAWN", KIND_DELTA, DELTAS, ["delta_smile_to_yawn"]),
+    (21, "DELTA_YAWN_TO_SMILE", KIND_DELTA, DELTAS, ["delta_yawn_to_smile"]),
+    (22, "DELTA_SMILE_TO_WINCING", KIND_DELTA, DELTAS, ["delta_smile_to_wincing"]),
+    (23, "DELTA_WINCING_TO_SMILE", KIND_DELTA, DELTAS, ["delta_wincing_to_smile"]),
+    (24, "DELTA_SMILE_TO_ASLEEP_SNORING", KIND_DELTA, DELTAS, ["delta_smile_to_asleepSnoring"]),
+    (25, "DELTA_ASLEEP_SNORING_TO_SMILE", KIND_DELTA, DELTAS, ["delta_asleepSnoring_to_smile"]),
+]
+
+PARTITIONS = "partitions_assets.csv"
+PARTITION_NAME = "assets"
+PACK_OUTPUT = ".pio/assets/assets.bin"
+IDS_OUTPUT = "include/generated/asset_ids.h"
+
+HEADER = struct.Struct("<4sHH")
+ENTRY = struct.Struct("<HBBII")
+
+
+def partition(project_dir):
+    """(offset, size) of the assets partition."""
+    with open(os.path.join(project_dir, PARTITIONS), "r", encoding="utf-8") as f:
+        for line in f:
+            fields = [field.strip() for field in line.split("#")[0].split(",")]
+            if len(fields) >= 5 and fields[0] == PARTITION_NAME:
+                return int(fields[3], 0), int(fields[4], 0)
+    raise ValueError("partition %s not found in %s" % (PARTITION_NAME, PARTITIONS))
+
+
+def build_pack(project_dir):
+    blobs = []
+    for asset_id, name, kind, header, arrays in PACK:
+        data = b"".join(read_header_array(os.path.join(project_dir, header), array) for array in arrays)
+        blobs.append((asset_id, name, kind, data))
+
+    offset = HEADER.size + len(blobs) * ENTRY.size
+    index = bytearray(HEADER.pack(b"BMOP", 1, len(blobs)))
+    body = bytearray()
+    for asset_id, _, kind, data in blobs:
+        pad = (-(offset + len(body))) % 4
+        body.extend(b"\xff" * pad)  # Erased-flash filler
+        index.extend(ENTRY.pack(asset_id, kind, 0, offset + len(body), len(data)))
+        body.extend(data)
+    return bytes(index + body), blobs
+
+
+def generate(project_dir):
+    pack, blobs = build_pack(project_dir)
+    _, size = partition(project_dir)
+    if len(pack) > size:
+        raise ValueError("asset pack is %d bytes, partition %s holds %d" % (len(pack), PARTITION_NAME, size))
+
+    output = os.path.join(project_dir, PACK_OUTPUT)
+    os.makedirs(os.path.dirname(output), exist_ok=True)
+    with open(output, "wb") as f:
+        f.write(pack)
+
+    parts = [
+        "/**",
+        " * @file asset_ids.h",
+        " * @brief Asset IDs in the pack built by scripts/pack_assets.py",
+        " *",
+        " * Do not edit: regenerated by the build. Pass to GDEH0154D67::displayAsset().",
+        " */",
+        "",
+        "#pragma once",
+        "",
+    ]
+    for asset_id, name, kind, data in blobs:
+        parts.append("static constexpr unsigned int ASSET_ID_%s = %d; ///< kind %d, %d bytes"
+                     % (name, asset_id, kind, len(data)))
+    parts.append("")
+    write_if_changed(os.path.join(project_dir, IDS_OUTPUT), "\n".join(parts), "pack_assets")
+    print("pack_assets: %d assets, %d of %d bytes" % (len(blobs), len(pack), size))
+    return output
+
+
+PACK_PATH = generate(PROJECT_DIR)
+
+if ENV is not None and ENV.get("PIOPLATFORM") == "espressif32":
+    OFFSET, _ = partition(PROJECT_DIR)
+    ENV.AddCustomTarget(
+        name="upload_assets",
+        dependencies=None,
+        actions=['"$PYTHONEXE" "$UPLOADER" --chip esp32 --port "$UPLOAD_PORT" write_flash 0x%X "%s"'
+                 % (OFFSET, PACK_PATH)],
+        title="Upload assets",
+        description="Write the asset pack to the assets partition",
+    )
@@ -0,0 +1,68 @@
+"""
+Pre-split 4-grayscale assets into SSD1681 plane images at build time.
+
+The 2bpp sources (gImage_11 in include/Ap_29demo.h and the 10000-byte face
+images in data/) are converted to the two inverted 5000-byte planes that
+displayFullScreen4Gray() sends to RAM 0x24 and 0x26, and written to
+include/generated/gray_planes.h. displayGrayPlanes() streams them unchanged.
+
+Runs as a PlatformIO pre: script (extra_scripts) or standalone:
+    python scripts/presplit_gray_assets.py [project_dir]
+The header is only rewritten when its content changes, so unchanged assets
+do not trigger a rebuild.
+"""
+
+import os
+import sys
+
+if __name__ == "__main__":
+    PROJECT_DIR = sys.argv[1] if len(sys.argv) > 1 else os.getcwd()
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+
+sys.path.insert(0, os.path.join(PROJECT_DIR, "scripts"))
+from asset_tools import GRAY_BYTES, format_array, read_source, split_planes, write_if_changed  # noqa: E402
+
+# (asset name, source) - see asset_tools.read_source
+ASSETS = [
+    ("gImage_11", ("header", "include/Ap_29demo.h", "gImage_11")),
+    ("smile", ("bin", "data/smile.bin")),
+    ("yawn", ("bin", "data/yawn.bin")),
+    ("wincing", ("bin", "data/wincing.bin")),
+    ("asleepSnoring", ("bin", "data/asleepSnoring.bin")),
+    ("smilingMouthClosed", ("bin", "data/smilingMouthClosed.bin")),
+]
+
+OUTPUT = "include/generated/gray_planes.h"
+
+
+def generate(project_dir):
+    parts = [
+        "/**",
+        " * @file gray_planes.h",
+        " * @brief Pre-split 4-grayscale planes, generated by scripts/presplit_gray_assets.py",
+        " *",
+        " * Do not edit: regenerated from the 2bpp sources by the build.",
+        " * Each asset is a GrayPlaneImage for GDEH0154D67::displayGrayPlanes().",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        '#include "GDEH0154D67_Display.h"',
+        "",
+    ]
+    for name, source in ASSETS:
+        gray, origin = read_source(project_dir, source, GRAY_BYTES)
+        plane_24, plane_26 = split_planes(gray)
+        parts.append("// %s" % origin)
+        parts.append(format_array("gray_planes_%s_24" % name, plane_24))
+        parts.append(format_array("gray_planes_%s_26" % name, plane_26))
+        parts.append("const GrayPlaneImage gray_planes_%s = { gray_planes_%s_24, gray_planes_%s_26 };"
+                     % (name, name, name))
+        parts.append("")
+
+    write_if_changed(os.path.join(project_dir, OUTPUT), "\n".join(parts), "presplit_gray_assets")
+
+
+generate(PROJECT_DIR)
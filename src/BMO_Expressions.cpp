@@ -0,0 +1,44 @@
+/**
+ * @file BMO_Expressions.cpp
+ * @brief Lookups into the generated expression tables
+ *
+ * The only translation unit that includes generated/bmo_expression_tables.h,
+ * so the region images and plans exist once in flash.
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#include "BMO_Expressions.h"
+#include "generated/bmo_expression_tables.h"
+
+static const FacePatchList NO_PATCHES = { nullptr, 0, 0 };
+
+const FacePatchList& BmoExpressionEngine::transition(BmoExpression from, BmoExpression to) {
+    if (from >= BMO_EXPRESSION_COUNT || to >= BMO_EXPRESSION_COUNT) {
+        return NO_PATCHES;
+    }
+    return BMO_TRANSITIONS[from][to];
+}
+
+const FacePatchList& BmoExpressionEngine::expression(BmoExpression expression) {
+    if (expression >= BMO_EXPRESSION_COUNT) {
+        return NO_PATCHES;
+    }
+    return BMO_EXPRESSION_FULL[expression];
+}
+
+const char* BmoExpressionEngine::name(BmoExpression expression) {
+    if (expression >= BMO_EXPRESSION_COUNT) {
+        return "?";
+    }
+    return BMO_EXPRESSION_NAMES[expression];
+}
+
+const FaceTimeline& BmoTimelinePlayer::timeline(BmoAnimation animation) {
+    if (animation >= BMO_ANIMATION_COUNT) {
+        return BMO_TIMELINES[BMO_ANIMATION_COUNT];  // End marker, no frames
+    }
+    return BMO_TIMELINES[animation];
+}
@@ -0,0 +1,93 @@
+/**
+ * @file GDEH0154D67_Asset.cpp
+ * @brief Streaming decoder for compressed GDEH0154D67 image containers
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#include "GDEH0154D67_Asset.h"
+
+GDEH0154D67_AssetDecoder::GDEH0154D67_AssetDecoder()
+    : payload_(nullptr), payload_length_(0), payload_pos_(0), raw_length_(0), produced_(0),
+      kind_(0), failed_(false), literal_left_(0), match_left_(0), match_distance_(0), window_pos_(0) {
+    memset(window_, 0, sizeof(window_));
+}
+
+bool GDEH0154D67_AssetDecoder::begin(const unsigned char* asset) {
+    payload_ = nullptr;
+    payload_length_ = 0;
+    payload_pos_ = 0;
+    raw_length_ = 0;
+    produced_ = 0;
+    kind_ = 0;
+    failed_ = true;
+    literal_left_ = 0;
+    match_left_ = 0;
+    match_distance_ = 0;
+    window_pos_ = 0;
+
+    if (asset == nullptr ||
+        pgm_read_byte(&asset[0]) != 'B' || pgm_read_byte(&asset[1]) != 'M' || pgm_read_byte(&asset[2]) != 'Z') {
+        return false;
+    }
+
+    kind_ = pgm_read_byte(&asset[3]);
+    if (kind_ != ASSET_MONO && kind_ != ASSET_GRAY_PLANES) {
+        return false;
+    }
+
+    raw_length_ = pgm_read_byte(&asset[4]) | (pgm_read_byte(&asset[5]) << 8);
+    payload_length_ = pgm_read_byte(&asset[6]) | (pgm_read_byte(&asset[7]) << 8);
+    payload_ = asset + HEADER_SIZE;
+    failed_ = false;
+    return true;
+}
+
+unsigned char GDEH0154D67_AssetDecoder::nextPayloadByte() {
+    if (payload_pos_ >= payload_length_) {
+        failed_ = true;
+        return 0;
+    }
+    return pgm_read_byte(&payload_[payload_pos_++]);
+}
+
+size_t GDEH0154D67_AssetDecoder::read(unsigned char* out, size_t max_length) {
+    size_t count = 0;
+
+    while (count < max_length && produced_ < raw_length_ && !failed_) {
+        unsigned char value;
+
+        if (literal_left_ > 0) {
+            value = nextPayloadByte();
+            literal_left_--;
+        } else if (match_left_ > 0) {
+            value = window_[(unsigned char)(window_pos_ - match_distance_)];
+            match_left_--;
+        } else {
+            // Next token
+            unsigned char token = nextPayloadByte();
+            if (token < 0x80) {
+                literal_left_ = token + 1;
+            } else {
+                match_left_ = (token & 0x7F) + 3;
+                match_distance_ = nextPayloadByte() + 1;
+                if (match_distance_ > produced_) {
+                    failed_ = true;  // Reference before the start of the image
+                }
+            }
+            continue;
+        }
+
+        if (failed_) {
+            break;
+        }
+
+        window_[window_pos_++] = value;
+        out[count++] = value;
+        produced_++;
+    }
+
+    return count;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file GDEH0154D67_AssetPack.cpp
+ * @brief Asset pack mapping: esp_partition_mmap() on the ESP32, POSIX mmap() on the host
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#include "GDEH0154D67_AssetPack.h"
+
+#ifdef ARDUINO
+#include <esp_idf_version.h>
+#include <esp_partition.h>
+#if ESP_IDF_VERSION_MAJOR < 5
+#include <esp_spi_flash.h>
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Data partition subtype of the "assets" partition (custom range 0x40-0xFE)
+static const uint8_t ASSET_PARTITION_SUBTYPE = 0x40;
+
+GDEH0154D67_AssetPack::GDEH0154D67_AssetPack()
+    : data_(nullptr), size_(0), entry_count_(0), map_handle_(0) {
+}
+
+GDEH0154D67_AssetPack::~GDEH0154D67_AssetPack() {
+    close();
+}
+
+#ifdef ARDUINO
+
+bool GDEH0154D67_AssetPack::open(const char* name) {
+    close();
+
+    const esp_partition_t* partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)ASSET_PARTITION_SUBTYPE, name);
+    if (partition == nullptr) {
+        return false;
+    }
+
+    const void* mapped = nullptr;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &handle);
+#else
+    spi_flash_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &mapped, &handle);
+#endif
+    if (err != ESP_OK) {
+        return false;
+    }
+
+    data_ = (const unsigned char*)mapped;
+    size_ = partition->size;
+    map_handle_ = handle;
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void GDEH0154D67_AssetPack::close() {
+    if (data_ != nullptr) {
+#if ESP_IDF_VERSION_MAJOR >= 5
+        esp_partition_munmap(map_handle_);
+#else
+        spi_flash_munmap(map_handle_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    entry_count_ = 0;
+    map_handle_ = 0;
+}
+
+#else
+
+bool GDEH0154D67_AssetPack::open(const char* name) {
+    close();
+
+    int fd = ::open(name, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file referenced
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    data_ = (const unsigned char*)mapped;
+    size_ = (size_t)info.st_size;
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void GDEH0154D67_AssetPack::close() {
+    if (data_ != nullptr) {
+        munmap((void*)data_, size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    entry_count_ = 0;
+    map_handle_ = 0;
+}
+
+#endif // ARDUINO
+
+bool GDEH0154D67_AssetPack::validate() {
+    if (size_ < HEADER_SIZE ||
+        data_[0] != 'B' || data_[1] != 'M' || data_[2] != 'O' || data_[3] != 'P' ||
+        readU16(data_ + 4) != VERSION) {
+        return false;
+    }
+
+    entry_count_ = readU16(data_ + 6);
+    if (HEADER_SIZE + (size_t)entry_count_ * ENTRY_SIZE > size_) {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < entry_count_; i++) {
+        const unsigned char* entry = data_ + HEADER_SIZE + i * ENTRY_SIZE;
+        unsigned long offset = readU32(entry + 4);
+        unsigned long length = readU32(entry + 8);
+        if (offset > size_ || length > size_ - offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const unsigned char* GDEH0154D67_AssetPack::find(unsigned int id, unsigned char* kind, size_t* length) const {
+    for (unsigned int i = 0; i < entry_count_; i++) {
+        const unsigned char* entry = data_ + HEADER_SIZE + i * ENTRY_SIZE;
+        if (readU16(entry) != id) {
+            continue;
+        }
+        if (kind != nullptr) {
+            *kind = entry[2];
+        }
+        if (length != nullptr) {
+            *length = readU32(entry + 8);
+        }
+        return data_ + readU32(entry + 4);
+    }
+    return nullptr;
+}
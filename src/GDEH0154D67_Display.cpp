@@ -3,6 +3,8 @@
  * @brief Implementation of professional E-Paper Display Controller
  * 
  * This implementation provides comprehensive control for the GDEH0154D67 1.54" e-paper display.
+ * Only the bus-independent parts live here; the bus-templated driver is in
+ * GDEH0154D67_Display_impl.h.
  * The code is based on manufacturer reference implementation with significant improvements
  * in structure, documentation, and error handling.
  * 
@@ -13,9 +15,16 @@
 
 #include "GDEH0154D67_Display.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ARDUINO
+#include <stdio.h>
+#endif
+
 // ===== 4-GRAYSCALE LOOKUP TABLE =====
 // This 159-byte LUT defines the voltage waveforms for 4-level grayscale operation
-static const unsigned char LUT_DATA_4Gray[159] = {
+const unsigned char GDEH0154D67_Base::LUT_DATA_4Gray[159] = {
     // Voltage transition sequences for grayscale rendering
     0x40, 0x48, 0x80, 0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
     0x8,  0x48, 0x10, 0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
@@ -38,689 +47,695 @@ static const unsigned char LUT_DATA_4Gray[159] = {
     0x22, 0x17, 0x41, 0x0,  0x32, 0x1C
 };
 
-// ===== CONSTRUCTOR & DESTRUCTOR =====
+// ===== FAST PARTIAL LOOKUP TABLE =====
+// Vendor partial-refresh waveform for the 1.54" SSD1681 panels
+// (WF_PARTIAL_1IN54_0 in the Waveshare reference code), used unchanged.
+// Voltage selections (phase A of each group; B, C and D stay at VSS):
+//   LUT0  group 0 VSS,  group 1 VSH1
+//   LUT1  group 0 VSL,  group 1 VSL
+//   LUT2  group 0 VSH1, group 1 VSH1
+//   LUT3  group 0 VSS,  group 1 VSL
+//   LUT4  idle
+// Timing: group 0 phase A for 15 frames, group 1 phases A and B for one frame
+// each, no repeats - 17 frames in total.
+// Tail as sent by loadCustomWaveform(): EOPQ 0x02, VGH 0x17, VSH1 0x41,
+// VSH2 0xB0, VSL 0x32, VCOM 0x28 (register encodings, see the SSD1681 datasheet)
+const unsigned char GDEH0154D67_Base::LUT_DATA_PartialFast[159] = {
+    // Voltage selections per LUT (4 phases per byte)
+    0x0,  0x40, 0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x80, 0x80, 0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x40, 0x40, 0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x80, 0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    // Timing groups: TP A, TP B, SR AB, TP C, TP D, SR CD, repeat
+    0xF,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x1,  0x1,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+    // Frame rate and gate scan selection
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x0,  0x0,  0x0,
+    0x02, 0x17, 0x41, 0xB0, 0x32, 0x28
+};
 
-GDEH0154D67_Display::GDEH0154D67_Display(int busy_pin, int rst_pin, int dc_pin, 
-                                         int cs_pin, int sck_pin, int sdi_pin)
-    : busy_pin_(busy_pin), rst_pin_(rst_pin), dc_pin_(dc_pin),
-      cs_pin_(cs_pin), sck_pin_(sck_pin), sdi_pin_(sdi_pin),
-      initialized_(false), debug_enabled_(false), last_error_("No error") {
-    
-    debugPrint("Display controller created with pin configuration");
-}
+// ===== INIT SEQUENCES =====
+#if __cplusplus < 201703L
+// Out-of-line definitions for toolchains before C++17 (no inline variables)
+constexpr InitCommand GDEH0154D67_Base::INIT_SEQUENCE_MONO[];
+constexpr InitCommand GDEH0154D67_Base::INIT_SEQUENCE_GRAY[];
+#endif
 
-GDEH0154D67_Display::~GDEH0154D67_Display() {
-    if (initialized_) {
-        debugPrint("Destructor: Putting display to sleep");
-        enterDeepSleep();
-    }
-}
+// ===== CONTROLLER CONFIGURATION =====
 
-// ===== INITIALIZATION & SETUP =====
+const unsigned char GDEH0154D67_Base::CONFIG_COMMANDS[CONFIG_REGISTER_COUNT] = {
+    0x01, 0x11, 0x3C, 0x18, 0x74, 0x7E
+};
 
-void GDEH0154D67_Display::initializePins() {
-    debugPrint("Initializing GPIO pins");
-    
-    // Configure pin directions
-    pinMode(busy_pin_, INPUT);   // BUSY is an input from display
-    pinMode(rst_pin_, OUTPUT);   // Reset control output
-    pinMode(dc_pin_, OUTPUT);    // Data/Command control output
-    pinMode(cs_pin_, OUTPUT);    // SPI Chip Select output
-    pinMode(sck_pin_, OUTPUT);   // SPI Clock output
-    pinMode(sdi_pin_, OUTPUT);   // SPI Data output
-    
-    // Set initial states - CS and RST inactive (high)
-    setCS_Inactive();
-    setRST_Inactive();
-    
-    debugPrint("GPIO pins initialized successfully");
-}
+// Register values per ControllerMode. known marks the registers a mode
+// depends on; the rest keep whatever they hold. 0x74/0x7E have no documented
+// reset value and are only written by the 4-gray setup.
+const GDEH0154D67_Base::ControllerConfig GDEH0154D67_Base::MODE_CONFIGS[4] = {
+    // MODE_OFF: power-on defaults after RST or SWRESET
+    { { 0xC7, 0x03, 0xC0, 0x48, 0x00, 0x00 }, 0x0F },
+    // MODE_MONO: 200 gate lines, X+/Y-, border follows content, internal sensor
+    { { 0xC7, 0x01, 0x05, 0x80, 0x00, 0x00 }, 0x0F },
+    // MODE_GRAY: as mono with a fixed border and tuned analog/digital blocks
+    { { 0xC7, 0x01, 0x00, 0x00, 0x54, 0x3B }, 0x37 },
+    // MODE_PARTIAL: reset addressing (X+/Y+) and the partial border
+    { { 0xC7, 0x03, 0x80, 0x00, 0x00, 0x00 }, 0x07 }
+};
 
-bool GDEH0154D67_Display::initializeMonochrome() {
-    debugPrint("Starting monochrome display initialization");
-    
-    // Hardware reset sequence - essential for reliable operation
-    setRST_Active();     // Assert reset (low)
-    delay(10);           // Hold reset for at least 10ms
-    setRST_Inactive();   // Release reset (high)
-    delay(10);           // Wait for display to boot
-    
-    // Wait for display to be ready after reset
-    waitBusy();
-    
-    // Soft reset command - clears internal state
-    writeCommand(0x12);  // SWRESET
-    waitBusy();
-    
-    // Configure display driver output control
-    writeCommand(0x01);  // Driver output control
-    writeData(0xC7);     // Set to 200 lines (0xC7 = 199+1)
-    writeData(0x00);     // Additional settings
-    writeData(0x00);     // Additional settings
-    
-    // Set data entry mode - controls how RAM addresses increment
-    writeCommand(0x11);  // Data entry mode
-    writeData(0x01);     // X increment, Y increment
-    
-    // Define the active display window - X address range
-    writeCommand(0x44);  // Set RAM X address start/end position
-    writeData(0x00);     // X start = 0
-    writeData(0x18);     // X end = 24 (25*8 = 200 pixels)
-    
-    // Define the active display window - Y address range  
-    writeCommand(0x45);  // Set RAM Y address start/end position
-    writeData(0xC7);     // Y start = 199 (bottom-up addressing)
-    writeData(0x00);     // Y start high byte
-    writeData(0x00);     // Y end = 0
-    writeData(0x00);     // Y end high byte
-    
-    // Configure border waveform - controls border color during refresh
-    writeCommand(0x3C);  // BorderWaveform
-    writeData(0x05);     // Border follows display content
-    
-    // Configure built-in temperature sensor for optimal refresh
-    writeCommand(0x18);  // Read built-in temperature sensor
-    writeData(0x80);     // Use internal temperature sensor
-    
-    // Set initial RAM address pointers
-    writeCommand(0x4E);  // Set RAM X address counter
-    writeData(0x00);     // Start at X = 0
-    writeCommand(0x4F);  // Set RAM Y address counter
-    writeData(0xC7);     // Start at Y = 199 (bottom)
-    writeData(0x00);     // High byte
-    
-    // Final ready check
-    waitBusy();
-    
-    initialized_ = true;
-    debugPrint("Monochrome initialization completed successfully");
-    return true;
+void GDEH0154D67_Base::trackControllerConfig(ControllerMode mode) {
+    const ControllerConfig& target = MODE_CONFIGS[mode];
+    for (unsigned int reg = 0; reg < CONFIG_REGISTER_COUNT; reg++) {
+        if (target.known & (1 << reg)) {
+            config_.value[reg] = target.value[reg];
+        }
+    }
+    config_.known |= target.known;
 }
 
-bool GDEH0154D67_Display::initialize4Grayscale() {
-    debugPrint("Starting 4-grayscale display initialization");
-    
-    // Hardware reset sequence
-    setRST_Active();
-    delay(10);
-    setRST_Inactive();
-    delay(10);
-    
-    waitBusy();
-    writeCommand(0x12); // Soft reset
-    waitBusy();
-    
-    // Configure analog and digital blocks for grayscale operation
-    writeCommand(0x74); // Set analog block control
-    writeData(0x54);    // Optimal settings for grayscale
-    writeCommand(0x7E); // Set digital block control
-    writeData(0x3B);    // Optimal settings for grayscale
-    
-    // Driver output control (same as monochrome)
-    writeCommand(0x01);
-    writeData(0xC7);
-    writeData(0x00);
-    writeData(0x00);
-    
-    // Data entry mode
-    writeCommand(0x11);
-    writeData(0x01);
-    
-    // Set RAM address ranges
-    writeCommand(0x44);
-    writeData(0x00);
-    writeData(0x18);
-    
-    writeCommand(0x45);
-    writeData(0xC7);
-    writeData(0x00);
-    writeData(0x00);
-    writeData(0x00);
-    
-    // Border waveform for grayscale
-    writeCommand(0x3C);
-    writeData(0x00);    // Different setting for grayscale
-    
-    // Configure voltage levels for grayscale operation
-    writeCommand(0x2C);  // VCOM voltage
-    writeData(LUT_DATA_4Gray[158]);  // Use value from LUT
-    
-    writeCommand(0x3F);  // EOPQ
-    writeData(LUT_DATA_4Gray[153]);
-    
-    writeCommand(0x03);  // VGH
-    writeData(LUT_DATA_4Gray[154]);
-    
-    writeCommand(0x04);  // VSH1, VSH2, VSL
-    writeData(LUT_DATA_4Gray[155]);
-    writeData(LUT_DATA_4Gray[156]);
-    writeData(LUT_DATA_4Gray[157]);
-    
-    // Load the custom lookup table for grayscale waveforms
-    loadGrayscaleLUT(LUT_DATA_4Gray);
-    
-    // Set initial RAM addresses
-    writeCommand(0x4E);
-    writeData(0x00);
-    writeCommand(0x4F);
-    writeData(0xC7);
-    writeData(0x00);
-    
-    waitBusy();
-    
-    initialized_ = true;
-    debugPrint("4-grayscale initialization completed successfully");
-    return true;
-}
+// ===== 4-GRAYSCALE PROCESSING =====
 
-// ===== FULL SCREEN OPERATIONS =====
+// Splits one 2bpp byte (4 pixels) into its plane nibbles:
+// high nibble = RAM1 bits (pixel bit 0), low nibble = RAM2 bits (pixel bit 1)
+const unsigned char GDEH0154D67_Base::GRAY_SPLIT_TABLE[256] = {
+    0x00, 0x10, 0x01, 0x11, 0x20, 0x30, 0x21, 0x31, 0x02, 0x12, 0x03, 0x13, 0x22, 0x32, 0x23, 0x33,
+    0x40, 0x50, 0x41, 0x51, 0x60, 0x70, 0x61, 0x71, 0x42, 0x52, 0x43, 0x53, 0x62, 0x72, 0x63, 0x73,
+    0x04, 0x14, 0x05, 0x15, 0x24, 0x34, 0x25, 0x35, 0x06, 0x16, 0x07, 0x17, 0x26, 0x36, 0x27, 0x37,
+    0x44, 0x54, 0x45, 0x55, 0x64, 0x74, 0x65, 0x75, 0x46, 0x56, 0x47, 0x57, 0x66, 0x76, 0x67, 0x77,
+    0x80, 0x90, 0x81, 0x91, 0xA0, 0xB0, 0xA1, 0xB1, 0x82, 0x92, 0x83, 0x93, 0xA2, 0xB2, 0xA3, 0xB3,
+    0xC0, 0xD0, 0xC1, 0xD1, 0xE0, 0xF0, 0xE1, 0xF1, 0xC2, 0xD2, 0xC3, 0xD3, 0xE2, 0xF2, 0xE3, 0xF3,
+    0x84, 0x94, 0x85, 0x95, 0xA4, 0xB4, 0xA5, 0xB5, 0x86, 0x96, 0x87, 0x97, 0xA6, 0xB6, 0xA7, 0xB7,
+    0xC4, 0xD4, 0xC5, 0xD5, 0xE4, 0xF4, 0xE5, 0xF5, 0xC6, 0xD6, 0xC7, 0xD7, 0xE6, 0xF6, 0xE7, 0xF7,
+    0x08, 0x18, 0x09, 0x19, 0x28, 0x38, 0x29, 0x39, 0x0A, 0x1A, 0x0B, 0x1B, 0x2A, 0x3A, 0x2B, 0x3B,
+    0x48, 0x58, 0x49, 0x59, 0x68, 0x78, 0x69, 0x79, 0x4A, 0x5A, 0x4B, 0x5B, 0x6A, 0x7A, 0x6B, 0x7B,
+    0x0C, 0x1C, 0x0D, 0x1D, 0x2C, 0x3C, 0x2D, 0x3D, 0x0E, 0x1E, 0x0F, 0x1F, 0x2E, 0x3E, 0x2F, 0x3F,
+    0x4C, 0x5C, 0x4D, 0x5D, 0x6C, 0x7C, 0x6D, 0x7D, 0x4E, 0x5E, 0x4F, 0x5F, 0x6E, 0x7E, 0x6F, 0x7F,
+    0x88, 0x98, 0x89, 0x99, 0xA8, 0xB8, 0xA9, 0xB9, 0x8A, 0x9A, 0x8B, 0x9B, 0xAA, 0xBA, 0xAB, 0xBB,
+    0xC8, 0xD8, 0xC9, 0xD9, 0xE8, 0xF8, 0xE9, 0xF9, 0xCA, 0xDA, 0xCB, 0xDB, 0xEA, 0xFA, 0xEB, 0xFB,
+    0x8C, 0x9C, 0x8D, 0x9D, 0xAC, 0xBC, 0xAD, 0xBD, 0x8E, 0x9E, 0x8F, 0x9F, 0xAE, 0xBE, 0xAF, 0xBF,
+    0xCC, 0xDC, 0xCD, 0xDD, 0xEC, 0xFC, 0xED, 0xFD, 0xCE, 0xDE, 0xCF, 0xDF, 0xEE, 0xFE, 0xEF, 0xFF
+};
 
-void GDEH0154D67_Display::displayFullScreenMono(const unsigned char* image_data, bool refresh_immediately) {
-    if (!initialized_) {
-        setError("Display not initialized");
-        return;
-    }
-    
-    debugPrint("Loading full screen monochrome image");
-    
-    // Send command to write to display RAM
-    writeCommand(0x24);  // Write RAM for black(0)/white(1)
-    
-    // Transfer all 5000 bytes of image data
-    for (unsigned int i = 0; i < MONO_BUFFER_SIZE; i++) {
-        // Use pgm_read_byte for compatibility with program memory storage
-        writeData(pgm_read_byte(&image_data[i]));
-    }
-    
-    // Trigger refresh if requested
-    if (refresh_immediately) {
-        refreshFull();
+void GDEH0154D67_Base::splitGray4(const unsigned char* gray, unsigned char* plane_new,
+                                  unsigned char* plane_old, size_t plane_bytes) {
+    for (size_t i = 0; i < plane_bytes; i++) {
+        unsigned char first = GRAY_SPLIT_TABLE[pgm_read_byte(&gray[2 * i])];
+        unsigned char second = GRAY_SPLIT_TABLE[pgm_read_byte(&gray[2 * i + 1])];
+        
+        // Inverted for correct display, same as ~convertGray2ToRam1/2
+        plane_new[i] = ~((first & 0xF0) | (second >> 4));
+        plane_old[i] = ~((first << 4) | (second & 0x0F));
     }
-    
-    debugPrint("Full screen monochrome image loaded");
 }
 
-void GDEH0154D67_Display::displayFullScreen4Gray(const unsigned char* image_data, bool refresh_immediately) {
-    if (!initialized_) {
-        setError("Display not initialized");
-        return;
-    }
-    
-    debugPrint("Loading full screen 4-grayscale image");
-    
-    // 4-grayscale requires writing to both RAM buffers with processed data
-    unsigned char temp_byte;
-    
-    // Write to RAM buffer 1
-    writeCommand(0x24);
-    for (unsigned int i = 0; i < GRAY_BUFFER_SIZE; i += 2) {
-        temp_byte = convertGray2ToRam1(*(image_data + i), *(image_data + i + 1));
-        writeData(~temp_byte);  // Invert for correct display
-    }
+unsigned char GDEH0154D67_Base::convertGray2ToRam1(unsigned char data1, unsigned char data2) {
+    unsigned char temp_data1 = data1;
+    unsigned char temp_data2 = data2;
+    unsigned char out_data = 0x00;
     
-    // Write to RAM buffer 2  
-    writeCommand(0x26);
-    for (unsigned int i = 0; i < GRAY_BUFFER_SIZE; i += 2) {
-        temp_byte = convertGray2ToRam2(*(image_data + i), *(image_data + i + 1));
-        writeData(~temp_byte);  // Invert for correct display
+    // Process first byte (4 pixels)
+    for (unsigned int i = 0; i < 4; i++) {
+        out_data <<= 1;
+        if (((temp_data1 & 0xC0) == 0xC0) || ((temp_data1 & 0xC0) == 0x40)) {
+            out_data |= 0x01;
+        } else {
+            out_data |= 0x00;
+        }
+        temp_data1 <<= 2;  // Move to next 2-bit pixel
     }
     
-    // Trigger refresh if requested
-    if (refresh_immediately) {
-        refresh4Grayscale();
+    // Process second byte (4 pixels)
+    for (unsigned int i = 0; i < 4; i++) {
+        out_data <<= 1;
+        if (((temp_data2 & 0xC0) == 0xC0) || ((temp_data2 & 0xC0) == 0x40)) {
+            out_data |= 0x01;
+        } else {
+            out_data |= 0x00;
+        }
+        temp_data2 <<= 2;  // Move to next 2-bit pixel
     }
     
-    debugPrint("Full screen 4-grayscale image loaded");
+    return out_data;
 }
 
-void GDEH0154D67_Display::clearScreen() {
-    debugPrint("Clearing screen to white");
+unsigned char GDEH0154D67_Base::convertGray2ToRam2(unsigned char data1, unsigned char data2) {
+    unsigned char temp_data1 = data1;
+    unsigned char temp_data2 = data2;
+    unsigned char out_data = 0x00;
     
-    if (!initialized_) {
-        setError("Display not initialized");
-        return;
+    // Process first byte (4 pixels) - different bit pattern for RAM2
+    for (unsigned int i = 0; i < 4; i++) {
+        out_data <<= 1;
+        if (((temp_data1 & 0xC0) == 0xC0) || ((temp_data1 & 0xC0) == 0x80)) {
+            out_data |= 0x01;
+        } else {
+            out_data |= 0x00;
+        }
+        temp_data1 <<= 2;  // Move to next 2-bit pixel
     }
     
-    // Write white data to entire display RAM
-    writeCommand(0x24);
-    for (unsigned int row = 0; row < DISPLAY_HEIGHT; row++) {
-        for (unsigned int col = 0; col < MAX_LINE_BYTES; col++) {
-            writeData(0xFF);  // 0xFF = all white pixels
+    // Process second byte (4 pixels) - different bit pattern for RAM2
+    for (unsigned int i = 0; i < 4; i++) {
+        out_data <<= 1;
+        if (((temp_data2 & 0xC0) == 0xC0) || ((temp_data2 & 0xC0) == 0x80)) {
+            out_data |= 0x01;
+        } else {
+            out_data |= 0x00;
         }
+        temp_data2 <<= 2;  // Move to next 2-bit pixel
     }
     
-    refreshFull();
-    debugPrint("Screen cleared to white");
+    return out_data;
 }
 
-// ===== PARTIAL REFRESH OPERATIONS =====
+// ===== SHADOW FRAMEBUFFER =====
 
-void GDEH0154D67_Display::setPartialRefreshBase(const unsigned char* base_image) {
-    if (!initialized_) {
-        setError("Display not initialized");
-        return;
+bool GDEH0154D67_Base::enableShadowBuffer(unsigned char* storage) {
+    if (shadow_ != nullptr) {
+        return true;
     }
     
-    debugPrint("Setting partial refresh base image");
-    
-    // For partial refresh, we need to load the base image into both RAM buffers
-    // This ensures partial updates work correctly against a known background
-    
-    // Load base image to RAM buffer 1
-    writeCommand(0x24);
-    for (unsigned int i = 0; i < MONO_BUFFER_SIZE; i++) {
-        writeData(pgm_read_byte(&base_image[i]));
+    if (storage == nullptr) {
+        storage = static_cast<unsigned char*>(malloc(SHADOW_BUFFER_SIZE));
+        if (storage == nullptr) {
+            setError("Not enough memory for shadow buffer");
+            return false;
+        }
+        shadow_owned_ = true;
     }
     
-    // Load same base image to RAM buffer 2 (for partial refresh comparison)
-    writeCommand(0x26);
-    for (unsigned int i = 0; i < MONO_BUFFER_SIZE; i++) {
-        writeData(pgm_read_byte(&base_image[i]));
+    shadow_ = storage;
+    memset(shadow_, 0xFF, SHADOW_BUFFER_SIZE);
+    shadow_valid_[PLANE_NEW] = false;  // Unknown until fully written
+    shadow_valid_[PLANE_OLD] = false;
+    cursor_.known = false;             // Unknown until the next reset
+    track_command_ = 0x00;
+    track_arg_count_ = 0;
+    debugPrint("Shadow buffer enabled");
+    return true;
+}
+
+void GDEH0154D67_Base::disableShadowBuffer() {
+    if (shadow_owned_) {
+        free(shadow_);
     }
-    
-    // Display the base image
-    refreshFull();
-    debugPrint("Partial refresh base image set");
+    shadow_ = nullptr;
+    shadow_owned_ = false;
 }
 
-bool GDEH0154D67_Display::updatePartialRegion(unsigned int x_start, unsigned int y_start,
-                                             const unsigned char* image_data,
-                                             unsigned int width, unsigned int height) {
-    if (!initialized_) {
-        setError("Display not initialized");
-        return false;
+const unsigned char* GDEH0154D67_Base::getShadowPlane(unsigned int plane) const {
+    if (shadow_ == nullptr || plane > PLANE_OLD) {
+        return nullptr;
     }
+    return shadow_ + plane * MONO_BUFFER_SIZE;
+}
+
+bool GDEH0154D67_Base::isShadowPlaneValid(unsigned int plane) const {
+    return shadow_ != nullptr && plane <= PLANE_OLD && shadow_valid_[plane];
+}
+
+void GDEH0154D67_Base::shadowTrackReset() {
+    // SSD1681 power-on defaults: full window, X/Y increment, counters at 0
+    cursor_.known = true;
+    cursor_.entry_mode = 0x03;
+    cursor_.x_start = 0;
+    cursor_.x_end = MAX_LINE_BYTES - 1;
+    cursor_.y_start = 0;
+    cursor_.y_end = DISPLAY_HEIGHT - 1;
+    cursor_.x = 0;
+    cursor_.y = 0;
+    track_command_ = 0x00;
+    track_arg_count_ = 0;
+}
+
+void GDEH0154D67_Base::shadowTrackCommand(unsigned char cmd) {
+    track_command_ = cmd;
+    track_arg_count_ = 0;
     
-    // Validate coordinates
-    if (x_start + width > DISPLAY_WIDTH || y_start + height > DISPLAY_HEIGHT) {
-        setError("Region coordinates exceed display bounds");
-        return false;
+    if (cmd == 0x12) {
+        shadowTrackReset();  // SWRESET
+        return;
     }
     
-    debugPrint("Updating partial region");
-    
-    // Convert pixel coordinates to byte coordinates
-    unsigned int x_start_byte = x_start / 8;
-    unsigned int x_end_byte = x_start_byte + (width / 8) - 1;
-    
-    // Handle Y coordinate addressing (display uses bottom-up addressing)
-    unsigned int y_start1 = 0;
-    unsigned int y_start2 = y_start;
-    if (y_start >= 256) {
-        y_start1 = y_start2 / 256;
-        y_start2 = y_start2 % 256;
+    if (cmd == 0x24 || cmd == 0x26) {
+        unsigned int plane = (cmd == 0x24) ? PLANE_NEW : PLANE_OLD;
+        bool y_increment = (cursor_.entry_mode & 0x02) != 0;
+        unsigned int y_first = y_increment ? 0 : DISPLAY_HEIGHT - 1;
+        unsigned int y_last = y_increment ? DISPLAY_HEIGHT - 1 : 0;
+        
+        // A write from the origin of the full-screen window defines the whole plane
+        track_full_write_ = cursor_.known && (cursor_.entry_mode & 0x05) == 0x01 &&
+                            cursor_.x_start == 0 && cursor_.x_end == MAX_LINE_BYTES - 1 &&
+                            cursor_.y_start == y_first && cursor_.y_end == y_last &&
+                            cursor_.x == 0 && cursor_.y == y_first;
+        track_written_ = 0;
+        
+        if (!cursor_.known) {
+            shadow_valid_[plane] = false;
+        }
     }
-    
-    unsigned int y_end1 = 0;
-    unsigned int y_end2 = y_start + height - 1;
-    if (y_end2 >= 256) {
-        y_end1 = y_end2 / 256;
-        y_end2 = y_end2 % 256;
+}
+
+void GDEH0154D67_Base::shadowTrackPatternFill(unsigned int plane, unsigned char pattern) {
+    if (!cursor_.known) {
+        shadow_valid_[plane] = false;
+        return;
     }
     
-    // Reset display for partial update
-    setRST_Active();
-    delay(10);
-    setRST_Inactive();
-    delay(10);
-    
-    // Configure border for partial update
-    writeCommand(0x3C);
-    writeData(0x80);  // Border setting for partial refresh
-    
-    // Set the partial window X range
-    writeCommand(0x44);
-    writeData(x_start_byte);  // X start
-    writeData(x_end_byte);    // X end
-    
-    // Set the partial window Y range
-    writeCommand(0x45);
-    writeData(y_start2);  // Y start low
-    writeData(y_start1);  // Y start high
-    writeData(y_end2);    // Y end low
-    writeData(y_end1);    // Y end high
+    // Checkerboard of step cells from the window corner; step codes 5-7 span 200 pixels
+    static const unsigned int STEP_PIXELS[8] = { 8, 16, 32, 64, 128, 200, 200, 200 };
+    unsigned int step_x_bytes = STEP_PIXELS[pattern & 0x07] / 8;
+    unsigned int step_y_rows = STEP_PIXELS[(pattern >> 4) & 0x07];
+    bool first_white = (pattern & 0x80) != 0;
     
-    // Set RAM address pointers to start of region
-    writeCommand(0x4E);
-    writeData(x_start_byte);
-    writeCommand(0x4F);
-    writeData(y_start2);
-    writeData(y_start1);
+    unsigned int x0 = cursor_.x_start < cursor_.x_end ? cursor_.x_start : cursor_.x_end;
+    unsigned int x1 = cursor_.x_start < cursor_.x_end ? cursor_.x_end : cursor_.x_start;
+    unsigned int y0 = cursor_.y_start < cursor_.y_end ? cursor_.y_start : cursor_.y_end;
+    unsigned int y1 = cursor_.y_start < cursor_.y_end ? cursor_.y_end : cursor_.y_start;
     
-    // Write the partial image data
-    writeCommand(0x24);
-    unsigned int data_size = (height * width) / 8;
-    for (unsigned int i = 0; i < data_size; i++) {
-        writeData(pgm_read_byte(&image_data[i]));
+    unsigned char* plane_data = shadow_ + plane * MONO_BUFFER_SIZE;
+    for (unsigned int y = y0; y <= y1 && y < DISPLAY_HEIGHT; y++) {
+        unsigned char* row = plane_data + (DISPLAY_HEIGHT - 1 - y) * MAX_LINE_BYTES;
+        for (unsigned int x = x0; x <= x1 && x < MAX_LINE_BYTES; x++) {
+            bool odd = (((x - x0) / step_x_bytes + (y - y0) / step_y_rows) & 1) != 0;
+            row[x] = (first_white != odd) ? 0xFF : 0x00;
+        }
     }
     
-    // Trigger partial refresh
-    refreshPartial();
-    
-    debugPrint("Partial region update completed");
-    return true;
+    // A fill of the whole RAM defines the plane
+    if (x0 == 0 && x1 >= MAX_LINE_BYTES - 1 && y0 == 0 && y1 >= DISPLAY_HEIGHT - 1) {
+        shadow_valid_[plane] = true;
+    }
 }
 
-bool GDEH0154D67_Display::updateMultipleRegions(const PartialRegion regions[5]) {
-    if (!initialized_) {
-        setError("Display not initialized");
-        return false;
-    }
-    
-    debugPrint("Starting multiple region update");
-    
-    // Reset display for partial update
-    setRST_Active();
-    delay(10);
-    setRST_Inactive();
-    delay(10);
-    
-    // Configure border for partial update
-    writeCommand(0x3C);
-    writeData(0x80);
-    
-    // Process each valid region
-    for (int region_idx = 0; region_idx < 5; region_idx++) {
-        const PartialRegion& region = regions[region_idx];
+void GDEH0154D67_Base::shadowTrackData(const unsigned char* data, size_t length) {
+    if (track_command_ == 0x24 || track_command_ == 0x26) {
+        unsigned int plane = (track_command_ == 0x24) ? PLANE_NEW : PLANE_OLD;
         
-        // Skip invalid regions
-        if (!region.isValid()) {
-            continue;
-        }
-        
-        // Validate coordinates
-        if (region.x_start + region.width > DISPLAY_WIDTH || 
-            region.x_start < 0 || region.y_start < 0 ||
-            region.y_start - region.height > DISPLAY_HEIGHT ||
-            region.height == 0 || region.width == 0 ||
-            region.height > DISPLAY_HEIGHT || region.width > DISPLAY_WIDTH) {
-            setError("Region coordinates exceed display bounds");
-            return false;
+        // Only X-first addressing (entry mode bit 2 clear) is used by this driver
+        if (!cursor_.known || (cursor_.entry_mode & 0x04) != 0) {
+            shadow_valid_[plane] = false;
+            return;
         }
         
-        // Convert coordinates and configure window
-        unsigned int x_start_byte = region.x_start / 8;
-        unsigned int x_end_byte = x_start_byte + (region.width / 8) - 1;
+        bool x_increment = (cursor_.entry_mode & 0x01) != 0;
+        bool y_increment = (cursor_.entry_mode & 0x02) != 0;
+        unsigned char* plane_data = shadow_ + plane * MONO_BUFFER_SIZE;
+        size_t offset = 0;
         
-        unsigned int y_start1 = 0;
-        unsigned int y_start2 = region.y_start - 1;  // Adjust for display addressing
-        if (region.y_start >= 256) {
-            y_start1 = y_start2 / 256;
-            y_start2 = y_start2 % 256;
+        while (offset < length) {
+            // Bytes that land on the current row before the X counter wraps
+            size_t run = 1;
+            if (x_increment && cursor_.x <= cursor_.x_end) {
+                run = cursor_.x_end - cursor_.x + 1;
+                if (run > length - offset) {
+                    run = length - offset;
+                }
+            }
+            
+            // Frame row 0 is RAM Y 199
+            if (cursor_.y < DISPLAY_HEIGHT && cursor_.x < MAX_LINE_BYTES) {
+                size_t copy = run;
+                if (cursor_.x + copy > MAX_LINE_BYTES) {
+                    copy = MAX_LINE_BYTES - cursor_.x;
+                }
+                unsigned char* row = plane_data + (DISPLAY_HEIGHT - 1 - cursor_.y) * MAX_LINE_BYTES;
+                memcpy_P(row + cursor_.x, data + offset, copy);
+            }
+            offset += run;
+            
+            // Advance the counters like the controller: X wraps inside the window and carries into Y
+            cursor_.x += run - 1;
+            if (cursor_.x == cursor_.x_end) {
+                cursor_.x = cursor_.x_start;
+                if (cursor_.y == cursor_.y_end) {
+                    cursor_.y = cursor_.y_start;
+                } else {
+                    cursor_.y = (cursor_.y + (y_increment ? 1 : -1)) & 0x1FF;
+                }
+            } else {
+                cursor_.x = (cursor_.x + (x_increment ? 1 : -1)) & 0x3F;
+            }
         }
         
-        unsigned int y_end1 = 0;
-        unsigned int y_end2 = region.y_start + region.height - 1;
-        if (y_end2 >= 256) {
-            y_end1 = y_end2 / 256;
-            y_end2 = y_end2 % 256;
-        }
-        
-        // Set window for this region
-        writeCommand(0x44);
-        writeData(x_start_byte);
-        writeData(x_end_byte);
-        
-        writeCommand(0x45);
-        writeData(y_start2);
-        writeData(y_start1);
-        writeData(y_end2);
-        writeData(y_end1);
-        
-        // Set RAM address
-        writeCommand(0x4E);
-        writeData(x_start_byte);
-        writeCommand(0x4F);
-        writeData(y_start2);
-        writeData(y_start1);
-        
-        // Write region data
-        writeCommand(0x24);
-        unsigned int data_size = (region.height * region.width) / 8;
-        for (unsigned int i = 0; i < data_size; i++) {
-            writeData(pgm_read_byte(&region.data[i]));
+        track_written_ += length;
+        if (track_full_write_ && track_written_ >= MONO_BUFFER_SIZE) {
+            shadow_valid_[plane] = true;
         }
+        return;
     }
     
-    // Trigger partial refresh for all regions
-    refreshPartial();
-    
-    debugPrint("Multiple region update completed");
-    return true;
-}
-
-// ===== DISPLAY REFRESH & UPDATE =====
-
-void GDEH0154D67_Display::refreshFull() {
-    debugPrint("Triggering full screen refresh");
-    
-    writeCommand(0x22);  // Display Update Control
-    writeData(0xF7);     // Full refresh with flicker
-    writeCommand(0x20);  // Activate Display Update Sequence
-    waitBusy();          // Wait for refresh to complete
-    
-    debugPrint("Full screen refresh completed");
-}
-
-void GDEH0154D67_Display::refreshPartial() {
-    debugPrint("Triggering partial refresh");
+    // Addressing commands take effect once all their arguments have arrived
+    unsigned int needed;
+    switch (track_command_) {
+        case 0x11: needed = 1; break;  // Data entry mode
+        case 0x44: needed = 2; break;  // RAM X window
+        case 0x45: needed = 4; break;  // RAM Y window
+        case 0x4E: needed = 1; break;  // RAM X counter
+        case 0x4F: needed = 2; break;  // RAM Y counter
+        case 0x46: needed = 1; break;  // Auto pattern fill, RED RAM
+        case 0x47: needed = 1; break;  // Auto pattern fill, BW RAM
+        default: return;
+    }
     
-    writeCommand(0x22);  // Display Update Control
-    writeData(0xFF);     // Partial refresh without flicker
-    writeCommand(0x20);  // Activate Display Update Sequence
-    waitBusy();          // Wait for refresh to complete
+    for (size_t i = 0; i < length && track_arg_count_ < needed; i++) {
+        track_args_[track_arg_count_++] = pgm_read_byte(&data[i]);
+    }
+    if (track_arg_count_ < needed) {
+        return;
+    }
     
-    debugPrint("Partial refresh completed");
+    const unsigned char* a = track_args_;
+    switch (track_command_) {
+        case 0x11:
+            cursor_.entry_mode = a[0] & 0x07;
+            break;
+        case 0x44:
+            cursor_.x_start = a[0] & 0x3F;
+            cursor_.x_end = a[1] & 0x3F;
+            break;
+        case 0x45:
+            cursor_.y_start = a[0] | ((a[1] & 0x01) << 8);
+            cursor_.y_end = a[2] | ((a[3] & 0x01) << 8);
+            break;
+        case 0x4E:
+            cursor_.x = a[0] & 0x3F;
+            break;
+        case 0x4F:
+            cursor_.y = a[0] | ((a[1] & 0x01) << 8);
+            break;
+        case 0x46:
+        case 0x47:
+            shadowTrackPatternFill(track_command_ == 0x47 ? PLANE_NEW : PLANE_OLD, a[0]);
+            break;
+    }
+    track_command_ = 0x00;  // Further data bytes are not addressing arguments
 }
 
-void GDEH0154D67_Display::refresh4Grayscale() {
-    debugPrint("Triggering 4-grayscale refresh");
-    
-    writeCommand(0x22);  // Display Update Control
-    writeData(0xC7);     // 4-grayscale refresh mode
-    writeCommand(0x20);  // Activate Display Update Sequence
-    waitBusy();          // Wait for refresh to complete
-    
-    debugPrint("4-grayscale refresh completed");
-}
+// ===== DIRTY RECTANGLES =====
 
-// ===== POWER MANAGEMENT =====
+namespace {
 
-void GDEH0154D67_Display::enterDeepSleep() {
-    debugPrint("Entering deep sleep mode");
-    
-    writeCommand(0x10);  // Enter deep sleep command
-    writeData(0x01);     // Deep sleep mode parameter
-    delay(100);          // Allow time for sleep transition
-    
-    initialized_ = false;  // Display will need re-initialization
-    debugPrint("Deep sleep mode activated");
+/**
+ * Bounding box of two rectangles
+ */
+FrameRect unionRect(const FrameRect& a, const FrameRect& b) {
+    return FrameRect(a.x_start_byte < b.x_start_byte ? a.x_start_byte : b.x_start_byte,
+                     a.x_end_byte > b.x_end_byte ? a.x_end_byte : b.x_end_byte,
+                     a.row_start < b.row_start ? a.row_start : b.row_start,
+                     a.row_end > b.row_end ? a.row_end : b.row_end);
 }
 
-bool GDEH0154D67_Display::isBusy() {
-    return readBusy();
+/**
+ * Rectangles overlap or touch (including diagonally)
+ */
+bool rectsTouch(const FrameRect& a, const FrameRect& b) {
+    return a.x_start_byte <= b.x_end_byte + 1 && b.x_start_byte <= a.x_end_byte + 1 &&
+           a.row_start <= b.row_end + 1 && b.row_start <= a.row_end + 1;
 }
 
-bool GDEH0154D67_Display::waitForReady(unsigned long timeout_ms) {
-    unsigned long start_time = millis();
-    
-    while (readBusy()) {
-        if (timeout_ms > 0 && (millis() - start_time) > timeout_ms) {
-            setError("Timeout waiting for display ready");
-            return false;
+/**
+ * Merge the pair whose bounding box adds the fewest bytes; returns the new count
+ */
+unsigned int mergeCheapestPair(FrameRect* rects, unsigned int count) {
+    unsigned int best_a = 0;
+    unsigned int best_b = 1;
+    unsigned int best_growth = ~0u;
+    
+    for (unsigned int a = 0; a < count; a++) {
+        for (unsigned int b = a + 1; b < count; b++) {
+            unsigned int merged = unionRect(rects[a], rects[b]).byteCount();
+            unsigned int separate = rects[a].byteCount() + rects[b].byteCount();
+            unsigned int growth = merged > separate ? merged - separate : 0;
+            if (growth < best_growth) {
+                best_growth = growth;
+                best_a = a;
+                best_b = b;
+            }
         }
-        delay(1);  // Small delay to prevent excessive polling
     }
     
-    return true;
+    rects[best_a] = unionRect(rects[best_a], rects[best_b]);
+    rects[best_b] = rects[count - 1];
+    return count - 1;
 }
 
-// ===== LOW-LEVEL SPI COMMUNICATION =====
-
-void GDEH0154D67_Display::spiWrite(unsigned char value) {
-    spiDelay(1);
-    
-    // Bit-bang SPI - send 8 bits MSB first
-    for (unsigned char bit = 0; bit < 8; bit++) {
-        setCLK_Low();
-        spiDelay(1);
-        
-        // Set data line based on current bit (MSB first)
-        if (value & 0x80) {
-            setMOSI_High();
-        } else {
-            setMOSI_Low();
+} // namespace
+
+unsigned int GDEH0154D67_Base::addDirtyRect(FrameRect* rects, unsigned int count, unsigned int max_rects,
+                                            const FrameRect& rect) {
+    if (max_rects == 0) {
+        return 0;
+    }
+    
+    // Absorb every rectangle the new one touches; the union may touch more
+    FrameRect merged = rect;
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (unsigned int i = 0; i < count; ) {
+            if (rectsTouch(rects[i], merged)) {
+                merged = unionRect(rects[i], merged);
+                rects[i] = rects[--count];
+                grew = true;
+            } else {
+                i++;
+            }
         }
-        
-        value <<= 1;  // Shift to next bit
-        spiDelay(1);
-        delayMicroseconds(1);  // Additional timing margin
-        
-        setCLK_High();  // Clock the bit
-        spiDelay(1);
     }
-}
-
-void GDEH0154D67_Display::writeCommand(unsigned char cmd) {
-    spiDelay(1);
-    setCS_Active();     // Select display
-    setDC_Command();    // Set to command mode
-    spiWrite(cmd);      // Send command byte
-    setCS_Inactive();   // Deselect display
-}
-
-void GDEH0154D67_Display::writeData(unsigned char data) {
-    spiDelay(1);
-    setCS_Active();     // Select display
-    setDC_Data();       // Set to data mode
-    spiWrite(data);     // Send data byte
-    setCS_Inactive();   // Deselect display
-}
-
-void GDEH0154D67_Display::waitBusy() {
-    // Wait while BUSY signal is high (display is busy)
-    while (readBusy()) {
-        // Small delay to prevent excessive polling
-        delay(1);
+    
+    if (count == max_rects) {
+        if (count == 1) {
+            rects[0] = unionRect(rects[0], merged);
+            return 1;
+        }
+        count = mergeCheapestPair(rects, count);
     }
+    rects[count++] = merged;
+    return count;
 }
 
-// ===== TIMING & DELAY FUNCTIONS =====
-
-void GDEH0154D67_Display::delayMicroseconds(unsigned int microseconds) {
-    // Simple microsecond delay using busy loop
-    for (; microseconds > 1; microseconds--) {
-        // Empty loop for timing
+unsigned int GDEH0154D67_Base::findDirtyRects(const unsigned char* old_frame, const unsigned char* new_frame,
+                                              FrameRect* rects, unsigned int max_rects) {
+    if (max_rects == 0) {
+        return 0;
     }
-}
-
-void GDEH0154D67_Display::delayMilliseconds(unsigned long milliseconds) {
-    unsigned long i, j;
-    for (j = 0; j < milliseconds; j++) {
-        for (i = 0; i < 256; i++) {
-            // Empty loop for timing
+    
+    // One bit per differing byte column, per row (25 columns fit in 32 bits)
+    uint32_t row_masks[DISPLAY_HEIGHT];
+    memset(row_masks, 0, sizeof(row_masks));
+    
+    // Word-wide compare; only words that differ are looked at byte by byte
+    for (unsigned int i = 0; i < MONO_BUFFER_SIZE; i += 4) {
+        uint32_t old_word;
+        uint32_t new_word;
+        memcpy_P(&old_word, old_frame + i, 4);
+        memcpy_P(&new_word, new_frame + i, 4);
+        if (old_word == new_word) {
+            continue;
         }
-    }
-}
-
-void GDEH0154D67_Display::spiDelay(unsigned char rate) {
-    unsigned char i;
-    while (rate) {
-        for (i = 0; i < 2; i++) {
-            // Empty loop for SPI timing
+        for (unsigned int k = 0; k < 4; k++) {
+            if (pgm_read_byte(&old_frame[i + k]) != pgm_read_byte(&new_frame[i + k])) {
+                unsigned int index = i + k;
+                row_masks[index / MAX_LINE_BYTES] |= 1UL << (index % MAX_LINE_BYTES);
+            }
         }
-        rate--;
     }
-}
-
-// ===== 4-GRAYSCALE PROCESSING =====
-
-unsigned char GDEH0154D67_Display::convertGray2ToRam1(unsigned char data1, unsigned char data2) {
-    unsigned char temp_data1 = data1;
-    unsigned char temp_data2 = data2;
-    unsigned char out_data = 0x00;
     
-    // Process first byte (4 pixels)
-    for (unsigned int i = 0; i < 4; i++) {
-        out_data <<= 1;
-        if (((temp_data1 & 0xC0) == 0xC0) || ((temp_data1 & 0xC0) == 0x40)) {
-            out_data |= 0x01;
-        } else {
-            out_data |= 0x00;
+    // Grow rectangles row by row from runs of differing bytes
+    unsigned int count = 0;
+    for (unsigned int row = 0; row < DISPLAY_HEIGHT; row++) {
+        uint32_t mask = row_masks[row];
+        unsigned int col = 0;
+        
+        while (mask != 0) {
+            while ((mask & 1) == 0) {
+                mask >>= 1;
+                col++;
+            }
+            unsigned int run_start = col;
+            while ((mask & 1) != 0) {
+                mask >>= 1;
+                col++;
+            }
+            FrameRect run(run_start, col - 1, row, row);
+            
+            // Join every rectangle this run touches
+            unsigned int target = count;
+            for (unsigned int i = 0; i < count; ) {
+                if (!rectsTouch(rects[i], run)) {
+                    i++;
+                    continue;
+                }
+                if (target == count) {
+                    rects[i] = unionRect(rects[i], run);
+                    target = i;
+                    i++;
+                } else {
+                    rects[target] = unionRect(rects[target], rects[i]);
+                    rects[i] = rects[--count];  // Re-check the moved rectangle
+                }
+            }
+            
+            if (target == count) {
+                if (count == max_rects && count == 1) {
+                    rects[0] = unionRect(rects[0], run);
+                    continue;
+                }
+                if (count == max_rects) {
+                    count = mergeCheapestPair(rects, count);
+                }
+                rects[count++] = run;
+            }
         }
-        temp_data1 <<= 2;  // Move to next 2-bit pixel
     }
     
-    // Process second byte (4 pixels)
-    for (unsigned int i = 0; i < 4; i++) {
-        out_data <<= 1;
-        if (((temp_data2 & 0xC0) == 0xC0) || ((temp_data2 & 0xC0) == 0x40)) {
-            out_data |= 0x01;
-        } else {
-            out_data |= 0x00;
+    // Bounding boxes of separate areas may still overlap
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (unsigned int a = 0; a < count && !merged; a++) {
+            for (unsigned int b = a + 1; b < count; b++) {
+                if (rects[a].overlaps(rects[b])) {
+                    rects[a] = unionRect(rects[a], rects[b]);
+                    rects[b] = rects[--count];
+                    merged = true;
+                    break;
+                }
+            }
         }
-        temp_data2 <<= 2;  // Move to next 2-bit pixel
     }
     
-    return out_data;
+    return count;
 }
 
-unsigned char GDEH0154D67_Display::convertGray2ToRam2(unsigned char data1, unsigned char data2) {
-    unsigned char temp_data1 = data1;
-    unsigned char temp_data2 = data2;
-    unsigned char out_data = 0x00;
-    
-    // Process first byte (4 pixels) - different bit pattern for RAM2
-    for (unsigned int i = 0; i < 4; i++) {
-        out_data <<= 1;
-        if (((temp_data1 & 0xC0) == 0xC0) || ((temp_data1 & 0xC0) == 0x80)) {
-            out_data |= 0x01;
-        } else {
-            out_data |= 0x00;
+float GDEH0154D67_Base::windowCost(const FrameRect& rect, const TransferCostModel& model) {
+    return model.transaction_us * WINDOW_TRANSACTIONS +
+           model.byte_us * (WINDOW_SETUP_BYTES + rect.byteCount());
+}
+
+unsigned int GDEH0154D67_Base::planWindows(const FrameRect* rects, unsigned int count, const TransferCostModel& model,
+                                           FrameRect* windows, unsigned char* assignment) {
+    for (unsigned int i = 0; i < count; i++) {
+        windows[i] = rects[i];
+        assignment[i] = i;
+    }
+    
+    unsigned int window_count = count;
+    while (window_count > 1) {
+        // Pair whose merge saves the most estimated time
+        float best_saving = 0.0f;
+        unsigned int best_a = 0;
+        unsigned int best_b = 0;
+        for (unsigned int a = 0; a < window_count; a++) {
+            for (unsigned int b = a + 1; b < window_count; b++) {
+                float saving = windowCost(windows[a], model) + windowCost(windows[b], model) -
+                               windowCost(unionRect(windows[a], windows[b]), model);
+                if (saving > best_saving) {
+                    best_saving = saving;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+        
+        if (best_saving <= 0.0f) {
+            break;
+        }
+        
+        // Merge b into a, move the last window into b's slot
+        windows[best_a] = unionRect(windows[best_a], windows[best_b]);
+        window_count--;
+        windows[best_b] = windows[window_count];
+        for (unsigned int i = 0; i < count; i++) {
+            if (assignment[i] == best_b) {
+                assignment[i] = best_a;
+            } else if (assignment[i] == window_count) {
+                assignment[i] = best_b;
+            }
         }
-        temp_data1 <<= 2;  // Move to next 2-bit pixel
     }
     
-    // Process second byte (4 pixels) - different bit pattern for RAM2
-    for (unsigned int i = 0; i < 4; i++) {
-        out_data <<= 1;
-        if (((temp_data2 & 0xC0) == 0xC0) || ((temp_data2 & 0xC0) == 0x80)) {
-            out_data |= 0x01;
-        } else {
-            out_data |= 0x00;
+    return window_count;
+}
+
+bool GDEH0154D67_Base::rectsEqual(const unsigned char* frame_a, const unsigned char* frame_b,
+                                  const FrameRect& rect) {
+    unsigned int row_bytes = rect.x_end_byte - rect.x_start_byte + 1;
+    for (unsigned int row = rect.row_start; row <= rect.row_end; row++) {
+        unsigned int offset = row * MAX_LINE_BYTES + rect.x_start_byte;
+        if (memcmp(frame_a + offset, frame_b + offset, row_bytes) != 0) {
+            return false;
         }
-        temp_data2 <<= 2;  // Move to next 2-bit pixel
     }
-    
-    return out_data;
+    return true;
 }
 
-void GDEH0154D67_Display::loadGrayscaleLUT(const unsigned char* wave_data) {
-    debugPrint("Loading 4-grayscale lookup table");
+bool GDEH0154D67_Base::validateFrameDelta(const unsigned char* delta) {
+    if (delta == nullptr ||
+        pgm_read_byte(&delta[0]) != 'B' || pgm_read_byte(&delta[1]) != 'M' || pgm_read_byte(&delta[2]) != 'D') {
+        return false;
+    }
     
-    writeCommand(0x32);  // Load LUT command
+    unsigned int record_count = pgm_read_byte(&delta[3]);
+    size_t payload_length = pgm_read_byte(&delta[4]) | (pgm_read_byte(&delta[5]) << 8);
+    size_t consumed = 0;
+    const unsigned char* record = delta + DELTA_HEADER_SIZE;
     
-    // Load 153 bytes of LUT data (first 153 bytes of the 159-byte table)
-    for (unsigned int count = 0; count < 153; count++) {
-        writeData(wave_data[count]);
+    for (unsigned int i = 0; i < record_count; i++) {
+        if (consumed + DELTA_RECORD_HEADER_SIZE > payload_length) {
+            return false;
+        }
+        FrameRect rect;
+        const unsigned char* xor_data = readDeltaRecord(record, rect);
+        if (rect.x_start_byte > rect.x_end_byte || rect.x_end_byte >= MAX_LINE_BYTES ||
+            rect.row_start > rect.row_end || rect.row_end >= DISPLAY_HEIGHT) {
+            return false;
+        }
+        consumed += DELTA_RECORD_HEADER_SIZE + rect.byteCount();
+        record = xor_data + rect.byteCount();
     }
     
-    debugPrint("4-grayscale LUT loaded");
+    return consumed == payload_length;
+}
+
+const unsigned char* GDEH0154D67_Base::readDeltaRecord(const unsigned char* record, FrameRect& rect) {
+    rect = FrameRect(pgm_read_byte(&record[0]), pgm_read_byte(&record[1]),
+                     pgm_read_byte(&record[2]), pgm_read_byte(&record[3]));
+    return record + DELTA_RECORD_HEADER_SIZE;
 }
 
 // ===== DEBUG HELPERS =====
 
-void GDEH0154D67_Display::debugPrint(const char* message) {
+void GDEH0154D67_Base::debugPrint(const char* message) {
     if (debug_enabled_) {
-        Serial.print("[GDEH0154D67] ");
-        Serial.println(message);
+        platformLogLine("[GDEH0154D67] ", message);
     }
 }
 
-void GDEH0154D67_Display::setError(const char* error) {
+void GDEH0154D67_Base::setError(const char* error) {
     last_error_ = error;
     if (debug_enabled_) {
-        Serial.print("[GDEH0154D67 ERROR] ");
-        Serial.println(error);
+        platformLogLine("[GDEH0154D67 ERROR] ", error);
     }
 }
+
+// ===== PLATFORM =====
+
+void platformLogLine(const char* tag, const char* message) {
+#ifdef ARDUINO
+    Serial.print(tag);
+    Serial.println(message);
+#else
+    printf("%s%s\n", tag, message);
+#endif
+}
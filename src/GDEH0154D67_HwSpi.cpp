@@ -0,0 +1,163 @@
+/**
+ * @file GDEH0154D67_HwSpi.cpp
+ * @brief Hardware SPI + DMA transport implementation for the GDEH0154D67 display
+ *
+ * @author Generated from manufacturer code
+ * @date 2025
+ * @version 1.0
+ */
+
+#include "GDEH0154D67_HwSpi.h"
+
+#include <string.h>
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+
+GDEH0154D67_HwSpi::GDEH0154D67_HwSpi()
+    : host_(SPI3_HOST), device_(nullptr), dma_buffers_{nullptr, nullptr}, active_(false) {
+    memset(transactions_, 0, sizeof(transactions_));
+}
+
+GDEH0154D67_HwSpi::~GDEH0154D67_HwSpi() {
+    end();
+}
+
+bool GDEH0154D67_HwSpi::begin(int sck_pin, int mosi_pin, uint32_t clock_hz) {
+    if (active_) {
+        return true;
+    }
+
+    // Input-only pins (34-39) and invalid pin numbers cannot be routed to SPI
+    if (!GPIO_IS_VALID_OUTPUT_GPIO(sck_pin) || !GPIO_IS_VALID_OUTPUT_GPIO(mosi_pin)) {
+        return false;
+    }
+
+    // Prefer the peripheral whose IO_MUX pins match, VSPI for everything else
+    host_ = (sck_pin == 14 && mosi_pin == 13) ? SPI2_HOST : SPI3_HOST;
+
+    spi_bus_config_t bus_config;
+    memset(&bus_config, 0, sizeof(bus_config));
+    bus_config.mosi_io_num = mosi_pin;
+    bus_config.miso_io_num = -1;       // Display is write-only
+    bus_config.sclk_io_num = sck_pin;
+    bus_config.quadwp_io_num = -1;
+    bus_config.quadhd_io_num = -1;
+    bus_config.max_transfer_sz = DMA_CHUNK_SIZE;
+
+    if (spi_bus_initialize(host_, &bus_config, SPI_DMA_CH_AUTO) != ESP_OK) {
+        return false;
+    }
+
+    spi_device_interface_config_t device_config;
+    memset(&device_config, 0, sizeof(device_config));
+    device_config.mode = 0;                   // CPOL=0, CPHA=0 as per SSD1681 timing
+    device_config.clock_speed_hz = clock_hz;
+    device_config.spics_io_num = -1;          // CS is driven by the display driver
+    device_config.queue_size = 2;             // One transaction per bounce buffer
+    device_config.flags = SPI_DEVICE_HALFDUPLEX | SPI_DEVICE_NO_DUMMY;
+
+    if (spi_bus_add_device(host_, &device_config, &device_) != ESP_OK) {
+        spi_bus_free(host_);
+        return false;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        dma_buffers_[i] = static_cast<uint8_t*>(heap_caps_malloc(DMA_CHUNK_SIZE, MALLOC_CAP_DMA));
+        if (dma_buffers_[i] == nullptr) {
+            active_ = true;  // Let end() release what was acquired
+            end();
+            return false;
+        }
+    }
+
+    active_ = true;
+    return true;
+}
+
+void GDEH0154D67_HwSpi::end() {
+    if (!active_) {
+        return;
+    }
+
+    if (device_ != nullptr) {
+        spi_bus_remove_device(device_);
+        device_ = nullptr;
+    }
+    spi_bus_free(host_);
+
+    for (int i = 0; i < 2; i++) {
+        if (dma_buffers_[i] != nullptr) {
+            heap_caps_free(dma_buffers_[i]);
+            dma_buffers_[i] = nullptr;
+        }
+    }
+
+    active_ = false;
+}
+
+void GDEH0154D67_HwSpi::writeByte(uint8_t value) {
+    spi_transaction_t transaction;
+    memset(&transaction, 0, sizeof(transaction));
+    transaction.flags = SPI_TRANS_USE_TXDATA;
+    transaction.length = 8;  // Length is in bits
+    transaction.tx_data[0] = value;
+
+    spi_device_polling_transmit(device_, &transaction);
+}
+
+void GDEH0154D67_HwSpi::writeBuffer(const uint8_t* data, size_t length) {
+    // Nothing to clock out: don't queue a zero-bit transaction
+    if (length == 0) {
+        return;
+    }
+
+    // Register arguments are only a few bytes: a polled transaction beats DMA setup
+    if (length <= 4) {
+        spi_transaction_t transaction;
+        memset(&transaction, 0, sizeof(transaction));
+        transaction.flags = SPI_TRANS_USE_TXDATA;
+        transaction.length = length * 8;
+        memcpy_P(transaction.tx_data, data, length);
+        spi_device_polling_transmit(device_, &transaction);
+        return;
+    }
+
+    size_t offset = 0;
+    int in_flight = 0;
+    int next = 0;
+
+    while (offset < length) {
+        // Reuse a bounce buffer only after its previous transfer has completed
+        if (in_flight == 2) {
+            spi_transaction_t* done = nullptr;
+            spi_device_get_trans_result(device_, &done, portMAX_DELAY);
+            in_flight--;
+        }
+
+        size_t chunk = length - offset;
+        if (chunk > DMA_CHUNK_SIZE) {
+            chunk = DMA_CHUNK_SIZE;
+        }
+
+        // Copy from RAM or flash into DMA-capable memory while the other chunk is on the wire
+        memcpy_P(dma_buffers_[next], data + offset, chunk);
+
+        spi_transaction_t& transaction = transactions_[next];
+        memset(&transaction, 0, sizeof(transaction));
+        transaction.length = chunk * 8;
+        transaction.tx_buffer = dma_buffers_[next];
+
+        spi_device_queue_trans(device_, &transaction, portMAX_DELAY);
+        in_flight++;
+
+        offset += chunk;
+        next ^= 1;
+    }
+
+    // Drain remaining transfers so the caller can release CS safely
+    while (in_flight > 0) {
+        spi_transaction_t* done = nullptr;
+        spi_device_get_trans_result(device_, &done, portMAX_DELAY);
+        in_flight--;
+    }
+}
@@ -60,6 +60,10 @@ void setup() {
     // Initialize GPIO pins for display communication
     display.initializePins();
     
+    // Shadow of controller RAM lets region updates share windows; measure SPI costs for the planner
+    display.enableShadowBuffer();
+    display.calibrateCostModel();
+    
     
     Serial.println("\\n--- Phase 4: Partial Refresh Demo Starting ---");
     Serial.println("Beginning digital clock simulation...");
@@ -78,6 +82,9 @@ void setup() {
     // // Set up base image for partial refresh (background pattern)
     display.setPartialRefreshBase(gImage_2);  // From Ap_29demo.h
     
+    // Reset + border setup once; clock updates only send windows and RAM data
+    display.beginPartialSession();
+    
     Serial.println("Setup completed successfully!");
     Serial.println("Starting main loop with digital clock demo...");
     
@@ -147,7 +154,7 @@ void loop() {
                     // After 59:59, perform a full refresh to clear any ghosting
                     minutes_high = 0;
                     Serial.println("\\n=== Performing full refresh to clear ghosting ===");
-                    display.initializeMonochrome();
+                    display.switchMode(DISPLAY_MODE_MONO);  // Registers only, no reset
                     display.clearScreen();
                     display.setPartialRefreshBase(gImage_basemap);
                     Serial.println("=== Full refresh completed, resuming clock ===\\n");
@@ -160,8 +167,8 @@ void loop() {
     // This is recommended best practice for e-paper displays
     if (update_count % 100 == 0) {
         Serial.println("\\n--- Periodic maintenance refresh ---");
-        display.initializeMonochrome();
-        display.setPartialRefreshBase(gImage_basemap);
+        display.switchMode(DISPLAY_MODE_MONO);  // Registers only, no reset
+        display.setPartialRefreshBase(gImage_basemap, FULL_REFRESH_FAST);  // Ghost clearing only: short waveform
         Serial.println("--- Maintenance refresh completed ---\\n");
     }
     
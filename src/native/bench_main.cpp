@@ -0,0 +1,300 @@
+/**
+ * @file bench_main.cpp
+ * @brief Transport-level benchmark: bytes, commands, CS toggles and wire time per driver API
+ *
+ * Every public upload call runs against a counting SimBus in front of the SSD1681
+ * emulator, using the worst-case noise frames from data/. Results are printed as
+ * JSON so regressions can be diffed or tracked by scripts.
+ *
+ * Usage: program [--data DIR] [--clock HZ]... [--cs-overhead-us US] [--table]
+ *   --data DIR          Directory holding noise_200x200_bw.bin / noise_200x200_2bpp.bin (default: data)
+ *   --clock HZ          SPI clock to estimate wire time for; repeatable (default: 1, 4, 10, 20 MHz)
+ *   --cs-overhead-us US Fixed cost per CS transaction in microseconds (default: 1.0)
+ *   --table             Human-readable table instead of JSON
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "GDEH0154D67_Display.h"
+#include "SSD1681_Emulator.h"
+#include "SimBusCounter.h"
+#include "Ap_29demo.h"
+#include "generated/face_deltas.h"
+#include "generated/bmo_face_regions.h"
+
+static GDEH0154D67<SimBus> display;
+static SSD1681Emulator panel;
+static SimBusCounter counter(&panel);
+
+static unsigned char noise_bw[5000];
+static unsigned char noise_gray[10000];
+
+// ===== BENCHMARK CASES =====
+
+/**
+ * @brief One benchmarked API call
+ * setup() runs uncounted and brings the controller into the state the call expects
+ */
+struct BenchCase {
+    const char* name;
+    void (*setup)();
+    void (*run)();
+};
+
+static void setupMono() {
+    display.initializeMonochrome();
+}
+
+static void setupGray() {
+    display.initialize4Grayscale();
+}
+
+static void setupPartial() {
+    display.endPartialSession();
+    display.setPartialWaveform(PARTIAL_WAVEFORM_OTP);
+    display.initializeMonochrome();
+    display.setPartialRefreshBase(noise_bw);
+}
+
+static void setupPartialSession() {
+    setupPartial();
+    display.beginPartialSession();
+}
+
+static void setupFastPartialSession() {
+    setupPartialSession();
+    display.setPartialWaveform(PARTIAL_WAVEFORM_FAST);
+    display.updateFaceRegion(BMO_FACE_LEFT_EYE, noise_bw + 1000);  // Loads the LUT once
+}
+
+static void runInitializeMonochrome() {
+    display.initializeMonochrome();
+}
+
+static void runInitialize4Grayscale() {
+    display.initialize4Grayscale();
+}
+
+static void runSwitchModeMono() {
+    display.switchMode(DISPLAY_MODE_MONO);
+}
+
+static void runSwitchModeGray() {
+    display.switchMode(DISPLAY_MODE_GRAY);
+}
+
+static void runClearScreen() {
+    display.clearScreen();
+}
+
+static void runClearScreenFast() {
+    display.clearScreen(FULL_REFRESH_FAST);
+}
+
+static void runFullScreenMono() {
+    display.displayFullScreenMono(noise_bw);
+}
+
+static void runFullScreen4Gray() {
+    display.displayFullScreen4Gray(noise_gray);
+}
+
+static void runSetPartialRefreshBase() {
+    display.setPartialRefreshBase(noise_bw);
+}
+
+static void runUpdatePartialRegion() {
+    // One 64x32 clock digit worth of noise
+    display.updatePartialRegion(0, 100, noise_bw, 64, 32);
+}
+
+static void runUpdateFromFrame() {
+    // Blink-sized change: 5 bytes x 32 rows differ from the panel
+    static unsigned char frame[5000];
+    memcpy(frame, noise_bw, sizeof(frame));
+    for (int row = 60; row < 92; row++) {
+        for (int col = 5; col < 10; col++) {
+            frame[row * 25 + col] ^= 0xFF;
+        }
+    }
+    display.updateFromFrame(frame);
+}
+
+static void runUpdateMultipleRegions() {
+    // Clock layout from main.cpp
+    PartialRegion regions[5];
+    regions[0] = PartialRegion(0,  32, 64, 32, Num[5]);
+    regions[1] = PartialRegion(40,  52, 64, 32, Num[9]);
+    regions[2] = PartialRegion(80,  84, 64, 32, gImage_numdot);
+    regions[3] = PartialRegion(120,  116, 64, 32, Num[5]);
+    regions[4] = PartialRegion(136, 200, 64, 32, Num[9]);
+    display.updateMultipleRegions(regions);
+}
+
+static void runUpdateRegionsFace() {
+    // left_eye, right_eye and nose_center from data/bmo_face_regions.json
+    // (frame rows r0..r1 map to PartialRegion y_start = 200 - r1)
+    PartialRegion regions[3];
+    regions[0] = PartialRegion(32,  110, 48, 41, noise_bw);
+    regions[1] = PartialRegion(120, 110, 48, 41, noise_bw + 1000);
+    regions[2] = PartialRegion(80,  120, 40, 21, noise_bw + 2000);
+    display.updateRegions(regions, 3);
+}
+
+static void runApplyFrameDelta() {
+    // Smile -> yawn face change (3 records)
+    display.applyFrameDelta(delta_smile_to_yawn);
+}
+
+static void runFillRect() {
+    // Clear the mouth region from data/bmo_face_regions.json
+    display.fillRect(FrameRect(8, 16, 120, 150), true);
+}
+
+static void runUpdateFaceRegion() {
+    // left_eye with its precomputed window bytes
+    display.updateFaceRegion(BMO_FACE_LEFT_EYE, noise_bw);
+}
+
+static const BenchCase BENCH_CASES[] = {
+    { "initializeMonochrome",   setupGray,    runInitializeMonochrome },
+    { "initialize4Grayscale",   setupMono,    runInitialize4Grayscale },
+    { "switchMode/mono",        setupGray,    runSwitchModeMono },
+    { "switchMode/gray",        setupMono,    runSwitchModeGray },
+    { "clearScreen",            setupMono,    runClearScreen },
+    { "clearScreen/fast",       setupMono,    runClearScreenFast },
+    { "displayFullScreenMono",  setupMono,    runFullScreenMono },
+    { "displayFullScreen4Gray", setupGray,    runFullScreen4Gray },
+    { "setPartialRefreshBase",  setupMono,    runSetPartialRefreshBase },
+    { "updatePartialRegion",    setupPartial, runUpdatePartialRegion },
+    { "updateMultipleRegions",  setupPartial, runUpdateMultipleRegions },
+    { "updatePartialRegion/session",   setupPartialSession, runUpdatePartialRegion },
+    { "updateMultipleRegions/session", setupPartialSession, runUpdateMultipleRegions },
+    { "updateFromFrame/session",       setupPartialSession, runUpdateFromFrame },
+    { "updateRegions/face",            setupPartialSession, runUpdateRegionsFace },
+    { "applyFrameDelta/session",       setupPartialSession, runApplyFrameDelta },
+    { "updateFaceRegion/session",      setupPartialSession, runUpdateFaceRegion },
+    { "fillRect/session",              setupPartialSession, runFillRect },
+    { "updateFaceRegion/fast",         setupFastPartialSession, runUpdateFaceRegion },
+};
+
+static const size_t BENCH_CASE_COUNT = sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]);
+
+// ===== HELPERS =====
+
+static bool loadFile(const char* dir, const char* name, unsigned char* out, size_t size) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+    bool ok = fread(out, 1, size, file) == size;
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "%s is shorter than %zu bytes\n", path, size);
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const char* data_dir = "data";
+    double clocks[8];
+    size_t clock_count = 0;
+    double cs_overhead_us = 1.0;
+    bool table = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--data") == 0 && i + 1 < argc) {
+            data_dir = argv[++i];
+        } else if (strcmp(argv[i], "--clock") == 0 && i + 1 < argc && clock_count < 8) {
+            clocks[clock_count++] = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--cs-overhead-us") == 0 && i + 1 < argc) {
+            cs_overhead_us = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--table") == 0) {
+            table = true;
+        } else {
+            fprintf(stderr, "Unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (clock_count == 0) {
+        const double defaults[] = { 1e6, 4e6, 10e6, 20e6 };
+        for (double clock : defaults) {
+            clocks[clock_count++] = clock;
+        }
+    }
+
+    if (!loadFile(data_dir, "noise_200x200_bw.bin", noise_bw, sizeof(noise_bw)) ||
+        !loadFile(data_dir, "noise_200x200_2bpp.bin", noise_gray, sizeof(noise_gray))) {
+        return 2;
+    }
+
+    display.bus().attach(&counter);
+    display.initializePins();
+    display.enableShadowBuffer();
+
+    if (table) {
+        printf("%-30s %8s %10s %10s %7s %9s", "api", "commands", "data_bytes", "cs_toggles", "resets", "wait_ms");
+        for (size_t c = 0; c < clock_count; c++) {
+            char label[24];
+            snprintf(label, sizeof(label), "wire_us@%gMHz", clocks[c] / 1e6);
+            printf("  %14s", label);
+        }
+        printf("\n");
+    } else {
+        printf("{\n  \"cs_overhead_us\": %g,\n  \"clocks_hz\": [", cs_overhead_us);
+        for (size_t c = 0; c < clock_count; c++) {
+            printf("%s%.0f", c ? ", " : "", clocks[c]);
+        }
+        printf("],\n  \"results\": [\n");
+    }
+
+    for (size_t i = 0; i < BENCH_CASE_COUNT; i++) {
+        const BenchCase& bench = BENCH_CASES[i];
+        bench.setup();
+        counter.reset();
+        bench.run();
+        const BusStats& stats = counter.stats();
+
+        if (table) {
+            printf("%-30s %8lu %10lu %10lu %7lu %9lu", bench.name, stats.commands, stats.data_bytes,
+                   stats.csToggles(), stats.resets, stats.wait_ms);
+            for (size_t c = 0; c < clock_count; c++) {
+                printf("  %14.1f", stats.wireTimeUs(clocks[c], cs_overhead_us));
+            }
+            printf("\n");
+            continue;
+        }
+
+        printf("    {\"api\": \"%s\", \"commands\": %lu, \"data_bytes\": %lu, \"cs_toggles\": %lu, "
+               "\"resets\": %lu, \"wait_ms\": %lu, \"wire_us\": [",
+               bench.name, stats.commands, stats.data_bytes, stats.csToggles(), stats.resets, stats.wait_ms);
+        for (size_t c = 0; c < clock_count; c++) {
+            printf("%s%.1f", c ? ", " : "", stats.wireTimeUs(clocks[c], cs_overhead_us));
+        }
+        printf("], \"opcodes\": {");
+        bool first = true;
+        for (int op = 0; op < 256; op++) {
+            if (stats.opcode_counts[op] > 0) {
+                printf("%s\"0x%02X\": %lu", first ? "" : ", ", op, stats.opcode_counts[op]);
+                first = false;
+            }
+        }
+        printf("}}%s\n", i + 1 < BENCH_CASE_COUNT ? "," : "");
+    }
+
+    if (!table) {
+        printf("  ]\n}\n");
+    }
+
+    if (panel.errorCount() > 0) {
+        fprintf(stderr, "Emulator reported %lu protocol errors, last: %s\n",
+                panel.errorCount(), panel.lastError());
+        return 1;
+    }
+    return 0;
+}
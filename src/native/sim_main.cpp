@@ -0,0 +1,339 @@
+/**
+ * @file sim_main.cpp
+ * @brief Host-native virtual panel: runs the display driver against the SSD1681 emulator
+ *
+ * Replays the same sequence as the firmware demo (clear, partial base image,
+ * clock digits via partial refresh) plus the 4-grayscale, asset, face and
+ * waveform paths, and writes the panel and both RAM planes after every step
+ * as PGM images.
+ *
+ * Usage: program [output_dir] [gray_image.bin] [asset_pack.bin]
+ *   output_dir      Directory for the PGM files (default: sim_output)
+ *   gray_image.bin  Optional 10000-byte 2bpp image (e.g. data/smile.bin)
+ *   asset_pack.bin  Asset pack from scripts/pack_assets.py (default: .pio/assets/assets.bin)
+ *
+ * This is a demo; the assertions live in the Unity tests under test/test_native
+ * (pio test -e native).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "GDEH0154D67_Display.h"
+#include "SSD1681_Emulator.h"
+#include "Ap_29demo.h"
+#include "generated/gray_planes.h"
+#include "generated/compressed_assets.h"
+#include "generated/face_deltas.h"
+#include "generated/asset_ids.h"
+#include "generated/bmo_face_regions.h"
+#include "BMO_Expressions.h"
+#include "GDEH0154D67_Service.h"
+#include "GDEH0154D67_Mailbox.h"
+
+// pio test -e native builds this file next to the Unity runner, which has its own main()
+#ifndef PIO_UNIT_TESTING
+
+static GDEH0154D67<SimBus> display;
+static SSD1681Emulator panel;
+static const char* output_dir = "sim_output";
+
+/**
+ * Write the panel and both RAM planes for one step
+ */
+static void dumpStep(const char* name) {
+    char path[256];
+
+    snprintf(path, sizeof(path), "%s/%s.pgm", output_dir, name);
+    panel.writePanelPgm(path);
+    snprintf(path, sizeof(path), "%s/%s_ram24.pgm", output_dir, name);
+    panel.writePlanePgm(SSD1681Emulator::PLANE_BW, path);
+    snprintf(path, sizeof(path), "%s/%s_ram26.pgm", output_dir, name);
+    panel.writePlanePgm(SSD1681Emulator::PLANE_RED, path);
+
+    // Shadow state next to the emulator counters, for eyeballing the PGMs
+    const char* shadow_state = "ok";
+    for (unsigned int plane = 0; plane < 2; plane++) {
+        static unsigned char ram[5000];
+        panel.copyPlaneAsFrame(plane, ram);
+        if (!display.isShadowPlaneValid(plane)) {
+            shadow_state = "partial";
+        } else if (memcmp(ram, display.getShadowPlane(plane), sizeof(ram)) != 0) {
+            shadow_state = "MISMATCH";
+            break;
+        }
+    }
+
+    printf("%-24s t=%6lu ms  refreshes=%lu  errors=%lu  shadow=%s\n", name,
+           display.bus().millis(), panel.refreshCount(), panel.errorCount(), shadow_state);
+}
+
+/**
+ * Expression switch queued as a display service job
+ */
+struct ExpressionJob {
+    BmoExpressionEngine* engine;
+    BmoExpression expression;
+};
+
+static void runExpressionJob(void* context) {
+    ExpressionJob* job = static_cast<ExpressionJob*>(context);
+    job->engine->setExpression(display, job->expression);
+}
+
+/**
+ * Completion callback for the asynchronous refresh step
+ */
+static void onRefreshDone(RefreshHandle handle, void* context) {
+    (void)handle;
+    *static_cast<bool*>(context) = true;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        output_dir = argv[1];
+    }
+    mkdir(output_dir, 0755);
+
+    display.bus().attach(&panel);
+    display.initializePins();
+    display.enableShadowBuffer();
+
+    // Same start-up as the firmware demo
+    display.initializeMonochrome();
+    display.clearScreen();
+    dumpStep("01_clear");
+
+    display.setPartialRefreshBase(gImage_2);
+    dumpStep("02_partial_base");
+
+    // Clock digits exactly as laid out in main.cpp, inside a partial session
+    display.beginPartialSession();
+    for (int second = 0; second < 3; second++) {
+        PartialRegion regions[5];
+        regions[0] = PartialRegion(0,  32, 64, 32, Num[0]);
+        regions[1] = PartialRegion(40,  52, 64, 32, Num[1]);
+        regions[2] = PartialRegion(80,  84, 64, 32, gImage_numdot);
+        regions[3] = PartialRegion(120,  116, 64, 32, Num[2]);
+        regions[4] = PartialRegion(136, 200, 64, 32, Num[second]);
+        display.updateMultipleRegions(regions);
+
+        char name[32];
+        snprintf(name, sizeof(name), "03_clock_%d", second);
+        dumpStep(name);
+    }
+
+    // Non-blocking refresh: keep "rendering" while the waveform runs
+    display.initializeMonochrome();
+    display.displayFullScreenMono(gImage_1, false);
+    unsigned long frames_while_busy = 0;
+    bool callback_ran = false;
+    display.refreshFullAsync(onRefreshDone, &callback_ran);
+    while (display.poll()) {
+        frames_while_busy++;
+        display.bus().delayMs(16);  // One 60 Hz frame of other work
+    }
+    printf("async refresh: %lu frames rendered while BUSY, callback %s\n", frames_while_busy,
+           callback_ran ? "ran" : "missing");
+    dumpStep("04_mono_image");
+
+    // Frame diff: invert two blocks, only they are uploaded
+    static unsigned char frame[5000];
+    memcpy(frame, gImage_1, sizeof(frame));
+    for (int row = 60; row < 100; row++) {
+        for (int col = 3; col < 8; col++) {
+            frame[row * 25 + col] ^= 0xFF;
+        }
+        frame[row * 25 + 20] ^= 0x3C;
+    }
+    display.updateFromFrame(frame);
+    dumpStep("04_frame_diff");
+
+    display.initialize4Grayscale();
+    display.displayFullScreen4Gray(gImage_11);
+    dumpStep("05_gray_image");
+
+    if (argc > 2) {
+        static unsigned char gray_image[10000];
+        FILE* file = fopen(argv[2], "rb");
+        if (file == nullptr || fread(gray_image, 1, sizeof(gray_image), file) != sizeof(gray_image)) {
+            fprintf(stderr, "Cannot read 10000-byte image %s\n", argv[2]);
+            return 1;
+        }
+        fclose(file);
+        display.displayFullScreen4Gray(gray_image);
+        dumpStep("06_gray_file");
+    }
+
+    // Build-time split planes and the streaming decoder of the compressed container
+    display.displayGrayPlanes(gray_planes_gImage_11);
+    dumpStep("07_gray_planes");
+    display.displayCompressedImage(asset_smile);
+    dumpStep("08_compressed");
+
+    // Face deltas: start from the compressed mono smile, XOR in other faces via partial updates
+    struct FaceStep {
+        const unsigned char* delta;
+        const char* name;
+    };
+    const FaceStep face_steps[] = {
+        { delta_smile_to_yawn, "09_delta_yawn" },
+        { delta_yawn_to_smile, "09_delta_smile" },
+        { delta_smile_to_wincing, "09_delta_wincing" },
+    };
+    display.initializeMonochrome();
+    display.displayCompressedImage(asset_face_smile);
+    for (const FaceStep& step : face_steps) {
+        display.applyFrameDelta(step.delta);
+        dumpStep(step.name);
+    }
+
+    // Asset pack: the same face change addressed by ID from a memory-mapped pack file
+    static GDEH0154D67_AssetPack pack;
+    const char* pack_path = argc > 3 ? argv[3] : ".pio/assets/assets.bin";
+    if (pack.open(pack_path)) {
+        display.setAssetPack(&pack);
+        display.displayAsset(ASSET_ID_DELTA_WINCING_TO_SMILE);
+        display.displayAsset(ASSET_ID_DELTA_SMILE_TO_YAWN);
+        dumpStep("10_pack_delta");
+
+        display.initialize4Grayscale();
+        display.displayAsset(ASSET_ID_YAWN);
+        dumpStep("10_pack_gray");
+    } else {
+        printf("Cannot map asset pack %s, skipping the pack steps\n", pack_path);
+    }
+
+    // Compile-time face region: invert the left eye of the mono smile
+    static unsigned char eye[BMO_FACE_LEFT_EYE.byteCount()];
+    display.initializeMonochrome();
+    display.displayCompressedImage(asset_face_smile);
+    const unsigned char* shown = display.getShadowPlane(GDEH0154D67_Base::PLANE_NEW);
+    unsigned int eye_bytes = 0;
+    for (unsigned int row = BMO_FACE_LEFT_EYE.row_end + 1; row-- > BMO_FACE_LEFT_EYE.row_start; ) {
+        for (unsigned int x = BMO_FACE_LEFT_EYE.x_start_byte; x <= BMO_FACE_LEFT_EYE.x_end_byte; x++) {
+            eye[eye_bytes++] = shown[row * 25 + x] ^ 0xFF;
+        }
+    }
+    display.updateFaceRegion(BMO_FACE_LEFT_EYE, eye);
+    dumpStep("11_face_region");
+
+    // Expression engine: first switch redraws every region, later ones send table deltas
+    static const BmoExpression expressions[] = {
+        BMO_EXPRESSION_HAPPY, BMO_EXPRESSION_EXCITED, BMO_EXPRESSION_SLEEPY,
+        BMO_EXPRESSION_ANGRY, BMO_EXPRESSION_ANGRY, BMO_EXPRESSION_NEUTRAL,
+    };
+    static BmoExpressionEngine engine;
+    for (BmoExpression expression : expressions) {
+        engine.setExpression(display, expression);
+    }
+    dumpStep("12_expressions");
+
+    // Timelines: deadlines stay on the start + at_ms grid however long refreshes take
+    static const struct {
+        BmoAnimation animation;
+        unsigned long run_ms;
+        const char* name;
+    } timelines[] = {
+        { BMO_ANIMATION_BLINK, 12000, "13_timeline_blink" },
+        { BMO_ANIMATION_TALK, 1000, "13_timeline_talk" },
+    };
+    static BmoTimelinePlayer player;
+    for (const auto& step : timelines) {
+        unsigned long start_time = display.bus().millis();
+        player.resetStats();
+        player.start(step.animation, start_time);
+        while (display.bus().millis() - start_time < step.run_ms) {
+            unsigned long shown_before = player.stats().frames_shown;
+            player.update(display, engine, display.bus().millis());
+            if (player.stats().frames_shown == shown_before) {
+                display.bus().delayMs(1);
+            }
+        }
+        const TimelineStats& stats = player.stats();
+        printf("%s: shown=%lu skipped=%lu missed=%lu max_late=%lu ms\n", step.name,
+               stats.frames_shown, stats.frames_skipped, stats.deadlines_missed, stats.max_lateness_ms);
+        dumpStep(step.name);
+    }
+    player.stop();
+
+    // Display service: a burst of expression jobs collapses to the newest one
+    static GDEH0154D67_Service<GDEH0154D67<SimBus>> service(display);
+    static ExpressionJob jobs[20];
+    for (unsigned int i = 0; i < 20; i++) {
+        jobs[i].engine = &engine;
+        jobs[i].expression = (BmoExpression)(i % BMO_EXPRESSION_COUNT);
+        service.pushJob(runExpressionJob, &jobs[i], GDEH0154D67_Service<GDEH0154D67<SimBus>>::KEY_USER);
+    }
+    service.processPending();
+    DisplayServiceStats service_stats = service.stats();
+    printf("14_service: pushed=%lu rejected=%lu coalesced=%lu executed=%lu\n", service_stats.pushed,
+           service_stats.rejected, service_stats.coalesced, service_stats.executed);
+    dumpStep("14_service");
+
+    // Mailbox: expressions posted while the first refresh runs are merged into one more refresh
+    static GDEH0154D67_Mailbox<GDEH0154D67<SimBus>> mailbox(display);
+    static const BmoExpression burst[] = {
+        BMO_EXPRESSION_HAPPY, BMO_EXPRESSION_SURPRISED, BMO_EXPRESSION_WINKING,
+        BMO_EXPRESSION_GAMING, BMO_EXPRESSION_CONFUSED, BMO_EXPRESSION_MUSICAL,
+    };
+    mailbox.begin();
+    for (BmoExpression expression : burst) {
+        const FacePatchList& full = BmoExpressionEngine::expression(expression);
+        mailbox.postFaceRegions(full.patches, full.count);
+    }
+    mailbox.flush();
+    engine.assume(burst[sizeof(burst) / sizeof(burst[0]) - 1]);
+    const MailboxStats& mailbox_stats = mailbox.stats();
+    printf("15_mailbox: posts=%lu commits=%lu merged=%lu\n", mailbox_stats.posts, mailbox_stats.commits,
+           mailbox_stats.merged);
+    dumpStep("15_mailbox");
+
+    // Auto pattern fill: blank the mouth black, then white, without sending pixel data
+    FrameRect mouth(BMO_FACE_MOUTH.x_start_byte, BMO_FACE_MOUTH.x_end_byte, BMO_FACE_MOUTH.row_start, BMO_FACE_MOUTH.row_end);
+    display.fillRect(mouth, false);
+    display.fillRect(mouth, true);
+    engine.invalidate();
+    dumpStep("16_fill_rect");
+
+    // Fast full refresh: forced-temperature waveform, same image, shorter BUSY
+    unsigned long fast_start = display.bus().millis();
+    display.refreshFull(FULL_REFRESH_FAST);
+    printf("17_fast_full: %lu ms (normal %lu ms)\n", display.bus().millis() - fast_start,
+           panel.timing().full_refresh_ms);
+    dumpStep("17_fast_full");
+
+    // Fast partial waveform: the custom LUT is loaded once per session and reused by every blink
+    static const BmoExpression blinks[] = {
+        BMO_EXPRESSION_THINKING, BMO_EXPRESSION_NEUTRAL, BMO_EXPRESSION_THINKING, BMO_EXPRESSION_NEUTRAL,
+    };
+    display.setPartialWaveform(PARTIAL_WAVEFORM_FAST);
+    display.beginPartialSession();
+    unsigned long lut_loads_before = panel.lutLoadCount();
+    unsigned long blink_start = display.bus().millis();
+    for (BmoExpression expression : blinks) {
+        engine.setExpression(display, expression);
+    }
+    unsigned long blink_ms = (display.bus().millis() - blink_start) / (sizeof(blinks) / sizeof(blinks[0]));
+    display.endPartialSession();
+    display.setPartialWaveform(PARTIAL_WAVEFORM_OTP);
+    printf("18_fast_partial: %lu ms per frame (OTP %lu ms), LUT loads=%lu\n", blink_ms,
+           panel.timing().partial_refresh_ms, panel.lutLoadCount() - lut_loads_before);
+    dumpStep("18_fast_partial");
+
+    // Mode switching: gray and mono content alternate without reset or re-initialization
+    unsigned long resets_before = panel.hardwareResetCount();
+    display.switchMode(DISPLAY_MODE_GRAY);
+    display.displayFullScreen4Gray(gImage_11);
+    dumpStep("19_mode_gray");
+    display.switchMode(DISPLAY_MODE_MONO);
+    display.displayFullScreenMono(gImage_1);
+    printf("19_mode_switch: hardware resets=%lu\n", panel.hardwareResetCount() - resets_before);
+    dumpStep("19_mode_mono");
+
+    display.enterDeepSleep();
+    return 0;
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,357 @@
+/**
+ * @file SSD1681_Emulator.cpp
+ * @brief Host-side SSD1681 command-stream emulator implementation
+ */
+
+#include "SSD1681_Emulator.h"
+
+#include <stdio.h>
+#include <string.h>
+
+SSD1681Emulator::SSD1681Emulator()
+    : busy_remaining_ms_(0), in_reset_(false), deep_sleep_(false),
+      refresh_count_(0), hw_reset_count_(0), lut_load_count_(0), error_count_(0), last_error_("No error") {
+    // Real RAM content is undefined at power-up; white keeps dumps deterministic
+    memset(ram_, 0xFF, sizeof(ram_));
+    memset(panel_, 0xFF, sizeof(panel_));
+    memset(lut_, 0x00, sizeof(lut_));
+
+    timing_.reset_ms = 10;
+    timing_.full_refresh_ms = 2000;
+    timing_.fast_full_refresh_ms = 1300;
+    timing_.partial_refresh_ms = 400;
+    timing_.lut_frame_us = 8000;
+    timing_.gray_refresh_ms = 1500;
+    timing_.pattern_fill_ms = 2;
+
+    resetRegisters();
+}
+
+// ===== REGISTER STATE =====
+
+void SSD1681Emulator::resetRegisters() {
+    x_start_ = 0;
+    x_end_ = RAM_X_BYTES - 1;
+    y_start_ = 0;
+    y_end_ = RAM_Y_ROWS - 1;
+    x_counter_ = 0;
+    y_counter_ = 0;
+    entry_mode_ = 0x03;      // POR default: X increment, Y increment
+    update_control_ = 0xFF;
+    lut_source_ = LUT_NONE;
+    temperature_c_ = 25;
+    temperature_forced_ = false;
+    lut_fast_ = false;
+    have_command_ = false;
+    arg_count_ = 0;
+}
+
+// ===== SimBusDevice =====
+
+void SSD1681Emulator::onCommand(uint8_t command) {
+    if (in_reset_ || deep_sleep_) {
+        return;  // Interface is inactive
+    }
+    if (busy_remaining_ms_ > 0) {
+        setError("Command sent while BUSY");
+    }
+
+    closeCommand();
+
+    int expected = expectedArgCount(command);
+    if (expected == -2) {
+        setError("Unknown command");
+    }
+
+    command_ = command;
+    arg_count_ = 0;
+    have_command_ = true;
+
+    if (expected == 0) {
+        applyCommand();
+    }
+}
+
+void SSD1681Emulator::onData(const uint8_t* data, size_t length) {
+    if (in_reset_ || deep_sleep_) {
+        return;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        if (!have_command_) {
+            setError("Data without an open command");
+            return;
+        }
+
+        int expected = expectedArgCount(command_);
+        if (expected == -1) {
+            writeRam(data[i]);
+            continue;
+        }
+        if (expected == -2) {
+            continue;  // Unknown command, already reported
+        }
+
+        args_[arg_count_++] = data[i];
+        if (arg_count_ == expected) {
+            applyCommand();
+        }
+    }
+}
+
+void SSD1681Emulator::onReset(bool active) {
+    if (active && !in_reset_) {
+        hw_reset_count_++;
+        resetRegisters();
+        deep_sleep_ = false;
+        busy_remaining_ms_ = 0;
+    }
+    in_reset_ = active;
+}
+
+void SSD1681Emulator::onDelay(unsigned long ms) {
+    busy_remaining_ms_ = (ms >= busy_remaining_ms_) ? 0 : busy_remaining_ms_ - ms;
+}
+
+// ===== COMMAND EXECUTION =====
+
+void SSD1681Emulator::closeCommand() {
+    if (!have_command_) {
+        return;
+    }
+    int expected = expectedArgCount(command_);
+    if (expected > 0 && arg_count_ < expected) {
+        setError("Command closed with missing arguments");
+    }
+    have_command_ = false;
+}
+
+void SSD1681Emulator::applyCommand() {
+    const uint8_t* a = args_;
+
+    switch (command_) {
+        case 0x10:
+            deep_sleep_ = (a[0] & 0x03) != 0;
+            break;
+        case 0x11:
+            entry_mode_ = a[0] & 0x07;
+            break;
+        case 0x12:
+            resetRegisters();
+            busy_remaining_ms_ = timing_.reset_ms;
+            break;
+        case 0x1A:
+            temperature_c_ = static_cast<int8_t>(a[0]);  // A[11:4]; the fraction nibble is ignored
+            temperature_forced_ = true;
+            break;
+        case 0x20:
+            activateUpdate();
+            break;
+        case 0x22:
+            update_control_ = a[0];
+            break;
+        case 0x32:
+            memcpy(lut_, a, LUT_SIZE);
+            lut_source_ = LUT_CUSTOM;
+            lut_load_count_++;
+            break;
+        case 0x44:
+            x_start_ = a[0] & 0x3F;
+            x_end_ = a[1] & 0x3F;
+            break;
+        case 0x45:
+            y_start_ = a[0] | ((a[1] & 0x01) << 8);
+            y_end_ = a[2] | ((a[3] & 0x01) << 8);
+            break;
+        case 0x46:
+            fillPattern(PLANE_RED, a[0]);
+            break;
+        case 0x47:
+            fillPattern(PLANE_BW, a[0]);
+            break;
+        case 0x4E:
+            x_counter_ = a[0] & 0x3F;
+            break;
+        case 0x4F:
+            y_counter_ = a[0] | ((a[1] & 0x01) << 8);
+            break;
+        default:
+            break;  // Accepted, no effect on the model
+    }
+
+    have_command_ = false;
+}
+
+void SSD1681Emulator::writeRam(uint8_t value) {
+    int plane = (command_ == 0x24) ? PLANE_BW : PLANE_RED;
+    if (x_counter_ < RAM_X_BYTES && y_counter_ < RAM_Y_ROWS) {
+        ram_[plane][y_counter_][x_counter_] = value;
+    }
+
+    bool x_increment = (entry_mode_ & 0x01) != 0;
+    bool y_increment = (entry_mode_ & 0x02) != 0;
+    bool y_first = (entry_mode_ & 0x04) != 0;
+
+    // Counters wrap inside the window; the inner axis carries into the outer one
+    if (!y_first) {
+        if (x_counter_ == x_end_) {
+            x_counter_ = x_start_;
+            if (y_counter_ == y_end_) {
+                y_counter_ = y_start_;
+            } else {
+                y_counter_ = (y_counter_ + (y_increment ? 1 : -1)) & 0x1FF;
+            }
+        } else {
+            x_counter_ = (x_counter_ + (x_increment ? 1 : -1)) & 0x3F;
+        }
+    } else {
+        if (y_counter_ == y_end_) {
+            y_counter_ = y_start_;
+            if (x_counter_ == x_end_) {
+                x_counter_ = x_start_;
+            } else {
+                x_counter_ = (x_counter_ + (x_increment ? 1 : -1)) & 0x3F;
+            }
+        } else {
+            y_counter_ = (y_counter_ + (y_increment ? 1 : -1)) & 0x1FF;
+        }
+    }
+}
+
+void SSD1681Emulator::fillPattern(int plane, uint8_t pattern) {
+    // Step sizes 8, 16, 32, 64, 128, 200 pixels; X steps are whole bytes
+    static const int STEP_PIXELS[8] = { 8, 16, 32, 64, 128, 200, 200, 200 };
+    int step_x_bytes = STEP_PIXELS[pattern & 0x07] / 8;
+    int step_y_rows = STEP_PIXELS[(pattern >> 4) & 0x07];
+    bool first_white = (pattern & 0x80) != 0;
+
+    int x0 = x_start_ < x_end_ ? x_start_ : x_end_;
+    int x1 = x_start_ < x_end_ ? x_end_ : x_start_;
+    int y0 = y_start_ < y_end_ ? y_start_ : y_end_;
+    int y1 = y_start_ < y_end_ ? y_end_ : y_start_;
+
+    for (int y = y0; y <= y1 && y < RAM_Y_ROWS; y++) {
+        for (int x = x0; x <= x1 && x < RAM_X_BYTES; x++) {
+            bool odd = (((x - x0) / step_x_bytes + (y - y0) / step_y_rows) & 1) != 0;
+            ram_[plane][y][x] = (first_white != odd) ? 0xFF : 0x00;
+        }
+    }
+
+    busy_remaining_ms_ = timing_.pattern_fill_ms;
+}
+
+void SSD1681Emulator::activateUpdate() {
+    bool load_temperature = (update_control_ & 0x20) != 0;
+    bool load_otp_lut = (update_control_ & 0x10) != 0;
+    bool display = (update_control_ & 0x04) != 0;
+    bool mode2 = (update_control_ & 0x08) != 0;
+
+    if (load_temperature) {
+        temperature_c_ = 25;  // Room temperature from the built-in sensor
+        temperature_forced_ = false;
+    }
+    if (load_otp_lut) {
+        lut_source_ = LUT_OTP;
+        lut_fast_ = temperature_forced_ && temperature_c_ >= 80;
+    }
+
+    if (!display) {
+        busy_remaining_ms_ = 50;  // Clock/analog/LUT load only
+        return;
+    }
+
+    if (lut_source_ == LUT_NONE) {
+        setError("Display update without a waveform");
+        return;
+    }
+
+    bool gray = (lut_source_ == LUT_CUSTOM) && !mode2;
+
+    for (int y = 0; y < HEIGHT; y++) {
+        int ram_y = RAM_Y_ROWS - 1 - y;
+        for (int x = 0; x < WIDTH; x++) {
+            uint8_t mask = 0x80 >> (x & 7);
+            bool bw = (ram_[PLANE_BW][ram_y][x >> 3] & mask) != 0;
+            bool red = (ram_[PLANE_RED][ram_y][x >> 3] & mask) != 0;
+
+            if (gray) {
+                int level = ((red ? 0 : 1) << 1) | (bw ? 0 : 1);
+                panel_[y][x] = static_cast<uint8_t>(level * 85);
+            } else if (mode2) {
+                if (bw != red) {
+                    panel_[y][x] = bw ? 255 : 0;  // Only changed pixels are driven
+                }
+            } else {
+                panel_[y][x] = bw ? 255 : 0;
+            }
+        }
+    }
+
+    refresh_count_++;
+    if (gray) {
+        busy_remaining_ms_ = timing_.gray_refresh_ms;
+    } else if (mode2 && lut_source_ == LUT_CUSTOM) {
+        busy_remaining_ms_ = customLutFrames() * timing_.lut_frame_us / 1000 + 1;
+    } else if (mode2) {
+        busy_remaining_ms_ = timing_.partial_refresh_ms;
+    } else if (lut_source_ == LUT_OTP && lut_fast_) {
+        busy_remaining_ms_ = timing_.fast_full_refresh_ms;
+    } else {
+        busy_remaining_ms_ = timing_.full_refresh_ms;
+    }
+}
+
+unsigned long SSD1681Emulator::customLutFrames() const {
+    // 12 timing groups of 7 bytes after the 60 voltage-selection bytes
+    unsigned long frames = 0;
+    for (int group = 0; group < 12; group++) {
+        const uint8_t* t = &lut_[60 + group * 7];
+        unsigned long ab = (unsigned long)(t[0] + t[1]) * (t[2] + 1);
+        unsigned long cd = (unsigned long)(t[3] + t[4]) * (t[5] + 1);
+        frames += (ab + cd) * (t[6] + 1);
+    }
+    return frames;
+}
+
+void SSD1681Emulator::setError(const char* error) {
+    error_count_++;
+    last_error_ = error;
+}
+
+// ===== INSPECTION =====
+
+void SSD1681Emulator::copyPlaneAsFrame(int plane, uint8_t* out) const {
+    for (int row = 0; row < RAM_Y_ROWS; row++) {
+        memcpy(out + row * RAM_X_BYTES, ram_[plane][RAM_Y_ROWS - 1 - row], RAM_X_BYTES);
+    }
+}
+
+bool SSD1681Emulator::writePanelPgm(const char* path) const {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "P5\n%d %d\n255\n", WIDTH, HEIGHT);
+    bool ok = fwrite(panel_, 1, sizeof(panel_), file) == sizeof(panel_);
+    fclose(file);
+    return ok;
+}
+
+bool SSD1681Emulator::writePlanePgm(int plane, const char* path) const {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "P5\n%d %d\n255\n", WIDTH, HEIGHT);
+    bool ok = true;
+    uint8_t row_pixels[WIDTH];
+    for (int y = 0; y < HEIGHT && ok; y++) {
+        int ram_y = RAM_Y_ROWS - 1 - y;
+        for (int x = 0; x < WIDTH; x++) {
+            row_pixels[x] = (ram_[plane][ram_y][x >> 3] & (0x80 >> (x & 7))) ? 255 : 0;
+        }
+        ok = fwrite(row_pixels, 1, WIDTH, file) == WIDTH;
+    }
+    fclose(file);
+    return ok;
+}
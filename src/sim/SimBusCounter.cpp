@@ -0,0 +1,50 @@
+/**
+ * @file SimBusCounter.cpp
+ * @brief Counting SimBusDevice decorator implementation
+ */
+
+#include "SimBusCounter.h"
+
+#include <string.h>
+
+SimBusCounter::SimBusCounter(SimBusDevice* target) : target_(target) {
+    reset();
+}
+
+void SimBusCounter::reset() {
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+void SimBusCounter::onCommand(uint8_t command) {
+    stats_.commands++;
+    stats_.opcode_counts[command]++;
+    if (target_) target_->onCommand(command);
+}
+
+void SimBusCounter::onData(const uint8_t* data, size_t length) {
+    stats_.data_bytes += length;
+    if (target_) target_->onData(data, length);
+}
+
+void SimBusCounter::onChipSelect(bool active) {
+    if (active) {
+        stats_.cs_assertions++;
+    }
+    if (target_) target_->onChipSelect(active);
+}
+
+void SimBusCounter::onReset(bool active) {
+    if (active) {
+        stats_.resets++;
+    }
+    if (target_) target_->onReset(active);
+}
+
+bool SimBusCounter::isBusy() {
+    return target_ != nullptr && target_->isBusy();
+}
+
+void SimBusCounter::onDelay(unsigned long ms) {
+    stats_.wait_ms += ms;
+    if (target_) target_->onDelay(ms);
+}
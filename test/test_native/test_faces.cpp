@@ -0,0 +1,97 @@
+/**
+ * @file test_faces.cpp
+ * @brief Compile-time face regions, the expression engine and timelines
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "test_support.h"
+#include "BMO_Expressions.h"
+#include "generated/bmo_face_regions.h"
+
+static void test_face_region_inverts_left_eye() {
+    static unsigned char frame[5000];
+    static unsigned char eye[BMO_FACE_LEFT_EYE.byteCount()];
+
+    showMonoSmile();
+    memcpy(frame, display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW), sizeof(frame));
+    unsigned int eye_bytes = 0;
+    for (unsigned int row = BMO_FACE_LEFT_EYE.row_end + 1; row-- > BMO_FACE_LEFT_EYE.row_start; ) {
+        for (unsigned int x = BMO_FACE_LEFT_EYE.x_start_byte; x <= BMO_FACE_LEFT_EYE.x_end_byte; x++) {
+            frame[row * 25 + x] ^= 0xFF;
+            eye[eye_bytes++] = frame[row * 25 + x];
+        }
+    }
+    TEST_ASSERT_TRUE(display->updateFaceRegion(BMO_FACE_LEFT_EYE, eye));
+    TEST_ASSERT_TRUE(panelShowsFrame(frame));
+}
+
+static void test_expression_engine_shows_every_expression() {
+    // First switch redraws every region, later ones send table deltas
+    static const BmoExpression expressions[] = {
+        BMO_EXPRESSION_HAPPY, BMO_EXPRESSION_EXCITED, BMO_EXPRESSION_SLEEPY,
+        BMO_EXPRESSION_ANGRY, BMO_EXPRESSION_ANGRY, BMO_EXPRESSION_NEUTRAL,
+    };
+    static unsigned char frame[5000];
+    BmoExpressionEngine engine;
+
+    showMonoSmile();
+    memcpy(frame, display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW), sizeof(frame));
+    for (BmoExpression expression : expressions) {
+        applyPatches(frame, BmoExpressionEngine::expression(expression));
+        TEST_ASSERT_TRUE_MESSAGE(engine.setExpression(*display, expression), BmoExpressionEngine::name(expression));
+        TEST_ASSERT_TRUE_MESSAGE(panelShowsFrame(frame), BmoExpressionEngine::name(expression));
+    }
+}
+
+/**
+ * @brief Play a timeline and check that every keyframe deadline was consumed
+ *
+ * Deadlines stay on the start + at_ms grid however long refreshes take, so
+ * the keyframes shown or merged must equal those due by the last update.
+ */
+static void checkTimeline(BmoAnimation animation, unsigned long run_ms, unsigned long expected_due) {
+    BmoExpressionEngine engine;
+    BmoTimelinePlayer player;
+
+    showMonoSmile();
+    unsigned long start_time = display->bus().millis();
+    unsigned long last_update = start_time;
+    player.start(animation, start_time);
+    while (display->bus().millis() - start_time < run_ms) {
+        last_update = display->bus().millis();
+        unsigned long shown = player.stats().frames_shown;
+        TEST_ASSERT_TRUE_MESSAGE(player.update(*display, engine, last_update), display->getLastError());
+        if (player.stats().frames_shown == shown) {
+            display->bus().delayMs(1);
+        }
+    }
+
+    unsigned long due = 0;
+    const FaceTimeline& timeline = BmoTimelinePlayer::timeline(animation);
+    for (unsigned long run = 0; run <= run_ms; run += timeline.period_ms ? timeline.period_ms : run_ms + 1) {
+        for (unsigned int i = 0; i < timeline.frame_count; i++) {
+            due += run + timeline.frames[i].at_ms <= last_update - start_time;
+        }
+    }
+    const TimelineStats& stats = player.stats();
+    TEST_ASSERT_EQUAL_UINT32(due, stats.frames_shown + stats.frames_skipped);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(expected_due, due);
+    player.stop();
+}
+
+static void test_blink_timeline_keeps_deadlines() {
+    checkTimeline(BMO_ANIMATION_BLINK, 12000, 6);  // 0, 300, 5000, 5300, 10000, 10300
+}
+
+static void test_talk_timeline_merges_late_frames() {
+    checkTimeline(BMO_ANIMATION_TALK, 1000, 14);   // Every 75 ms, refreshes take longer
+}
+
+void runFaceTests() {
+    RUN_TEST(test_face_region_inverts_left_eye);
+    RUN_TEST(test_expression_engine_shows_every_expression);
+    RUN_TEST(test_blink_timeline_keeps_deadlines);
+    RUN_TEST(test_talk_timeline_merges_late_frames);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file test_images.cpp
+ * @brief 4-gray planes, compressed images, frame deltas and the asset pack
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "test_support.h"
+#include "Ap_29demo.h"
+#include "GDEH0154D67_AssetPack.h"
+#include "generated/gray_planes.h"
+#include "generated/compressed_assets.h"
+#include "generated/face_deltas.h"
+#include "generated/asset_ids.h"
+
+/// Asset pack written by scripts/pack_assets.py, relative to the project directory
+static const char* const ASSET_PACK_PATH = ".pio/assets/assets.bin";
+
+/**
+ * @brief Mono frame of a face: the inverted high bits of its 4-gray image
+ */
+static void monoFaceFrame(const unsigned char* gray_plane_26, unsigned char* frame) {
+    for (unsigned int i = 0; i < 5000; i++) {
+        frame[i] = ~gray_plane_26[i];
+    }
+}
+
+static void test_gray_planes_match_runtime_split() {
+    display->initialize4Grayscale();
+    display->displayFullScreen4Gray(gImage_11);
+    TEST_ASSERT_TRUE(panel->customLutLoaded());
+
+    // Build-time split planes must load the same RAM contents as the runtime split
+    static unsigned char split_24[5000];
+    static unsigned char split_26[5000];
+    panel->copyPlaneAsFrame(SSD1681Emulator::PLANE_BW, split_24);
+    panel->copyPlaneAsFrame(SSD1681Emulator::PLANE_RED, split_26);
+    display->displayGrayPlanes(gray_planes_gImage_11);
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_BW, split_24));
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_RED, split_26));
+}
+
+static void test_compressed_image_matches_planes() {
+    display->initialize4Grayscale();
+    TEST_ASSERT_TRUE_MESSAGE(display->displayCompressedImage(asset_smile), display->getLastError());
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_BW, gray_planes_smile.ram_24));
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_RED, gray_planes_smile.ram_26));
+}
+
+static void test_face_deltas_reach_target_faces() {
+    struct FaceStep {
+        const unsigned char* delta;
+        const unsigned char* gray_plane_26;
+    };
+    const FaceStep face_steps[] = {
+        { delta_smile_to_yawn, gray_planes_yawn_26 },
+        { delta_yawn_to_smile, gray_planes_smile_26 },
+        { delta_smile_to_wincing, gray_planes_wincing_26 },
+    };
+    static unsigned char frame[5000];
+
+    showMonoSmile();
+    for (const FaceStep& step : face_steps) {
+        TEST_ASSERT_TRUE_MESSAGE(display->applyFrameDelta(step.delta), display->getLastError());
+        monoFaceFrame(step.gray_plane_26, frame);
+        TEST_ASSERT_TRUE(panelShowsFrame(frame));
+    }
+}
+
+static void test_asset_pack_delta_by_id() {
+    GDEH0154D67_AssetPack pack;
+    static unsigned char frame[5000];
+
+    TEST_ASSERT_TRUE_MESSAGE(pack.open(ASSET_PACK_PATH), "Cannot map .pio/assets/assets.bin");
+    showMonoSmile();
+    TEST_ASSERT_TRUE_MESSAGE(display->applyFrameDelta(delta_smile_to_wincing), display->getLastError());
+    display->setAssetPack(&pack);
+    TEST_ASSERT_TRUE_MESSAGE(display->displayAsset(ASSET_ID_DELTA_WINCING_TO_SMILE), display->getLastError());
+    TEST_ASSERT_TRUE_MESSAGE(display->displayAsset(ASSET_ID_DELTA_SMILE_TO_YAWN), display->getLastError());
+    monoFaceFrame(gray_planes_yawn_26, frame);
+    TEST_ASSERT_TRUE(panelShowsFrame(frame));
+}
+
+static void test_asset_pack_gray_planes_by_id() {
+    GDEH0154D67_AssetPack pack;
+
+    TEST_ASSERT_TRUE_MESSAGE(pack.open(ASSET_PACK_PATH), "Cannot map .pio/assets/assets.bin");
+    display->initialize4Grayscale();
+    display->setAssetPack(&pack);
+    TEST_ASSERT_TRUE_MESSAGE(display->displayAsset(ASSET_ID_YAWN), display->getLastError());
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_BW, gray_planes_yawn_24));
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_RED, gray_planes_yawn_26));
+    TEST_ASSERT_FALSE(display->displayAsset(999));
+}
+
+void runImageTests() {
+    RUN_TEST(test_gray_planes_match_runtime_split);
+    RUN_TEST(test_compressed_image_matches_planes);
+    RUN_TEST(test_face_deltas_reach_target_faces);
+    RUN_TEST(test_asset_pack_delta_by_id);
+    RUN_TEST(test_asset_pack_gray_planes_by_id);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file test_main.cpp
+ * @brief Host-native driver tests: fixture and Unity runner
+ *
+ * Run with: pio test -e native
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "test_support.h"
+#include "generated/compressed_assets.h"
+
+SimDisplay* display = nullptr;
+SSD1681Emulator* panel = nullptr;
+
+bool panelShowsFrame(const unsigned char* frame) {
+    for (int y = 0; y < 200; y++) {
+        for (int x = 0; x < 200; x++) {
+            bool white = (frame[y * 25 + x / 8] & (0x80 >> (x % 8))) != 0;
+            if (panel->panelPixel(x, y) != (white ? 255 : 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool ramPlaneEquals(unsigned int plane, const unsigned char* frame) {
+    static unsigned char ram[5000];
+    panel->copyPlaneAsFrame(plane, ram);
+    return memcmp(ram, frame, sizeof(ram)) == 0;
+}
+
+void applyPatches(unsigned char* frame, const FacePatchList& patches) {
+    for (unsigned int p = 0; p < patches.count; p++) {
+        const FaceRegion& region = *patches.patches[p].region;
+        const unsigned char* data = patches.patches[p].data;
+        unsigned int width = region.x_end_byte - region.x_start_byte + 1;
+        for (unsigned int row = region.row_end + 1; row-- > region.row_start; ) {
+            memcpy(&frame[row * 25 + region.x_start_byte], data, width);
+            data += width;
+        }
+    }
+}
+
+void showMonoSmile() {
+    display->initializeMonochrome();
+    TEST_ASSERT_TRUE_MESSAGE(display->displayCompressedImage(asset_face_smile), display->getLastError());
+}
+
+void setUp() {
+    panel = new SSD1681Emulator();
+    display = new SimDisplay();
+    display->bus().attach(panel);
+    display->initializePins();
+    display->enableShadowBuffer();
+}
+
+void tearDown() {
+    // The driver's shadow must match controller RAM for every plane it claims to know
+    bool shadow_matches = true;
+    for (unsigned int plane = 0; plane < 2; plane++) {
+        if (display->isShadowPlaneValid(plane) && !ramPlaneEquals(plane, display->getShadowPlane(plane))) {
+            shadow_matches = false;
+        }
+    }
+    // The destructor sends the deep sleep command, count its errors too
+    delete display;
+    unsigned long errors = panel->errorCount();
+    const char* last_error = panel->lastError();
+    delete panel;
+    display = nullptr;
+    panel = nullptr;
+
+    TEST_ASSERT_TRUE_MESSAGE(shadow_matches, "Shadow buffer diverged from controller RAM");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, errors, last_error);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    runRefreshTests();
+    runImageTests();
+    runFaceTests();
+    runServiceTests();
+    runWaveformTests();
+    return UNITY_END();
+}
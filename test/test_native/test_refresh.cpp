@@ -0,0 +1,205 @@
+/**
+ * @file test_refresh.cpp
+ * @brief Full, partial and asynchronous monochrome refresh tests
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "test_support.h"
+#include "Ap_29demo.h"
+
+static void test_clear_screen_shows_white() {
+    static unsigned char white[5000];
+    memset(white, 0xFF, sizeof(white));
+
+    display->initializeMonochrome();
+    display->clearScreen();
+    TEST_ASSERT_TRUE(panelShowsFrame(white));
+    TEST_ASSERT_EQUAL_UINT32(1, panel->refreshCount());
+}
+
+static void test_partial_base_loads_both_planes() {
+    display->initializeMonochrome();
+    display->setPartialRefreshBase(gImage_2);
+    TEST_ASSERT_TRUE(panelShowsFrame(gImage_2));
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_BW, gImage_2));
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_RED, gImage_2));
+}
+
+static void test_clock_digits_in_partial_session() {
+    // Clock digits exactly as laid out in main.cpp
+    display->initializeMonochrome();
+    display->clearScreen();
+    display->setPartialRefreshBase(gImage_2);
+    display->beginPartialSession();
+    for (int second = 0; second < 3; second++) {
+        PartialRegion regions[5];
+        regions[0] = PartialRegion(0,  32, 64, 32, Num[0]);
+        regions[1] = PartialRegion(40,  52, 64, 32, Num[1]);
+        regions[2] = PartialRegion(80,  84, 64, 32, gImage_numdot);
+        regions[3] = PartialRegion(120,  116, 64, 32, Num[2]);
+        regions[4] = PartialRegion(136, 200, 64, 32, Num[second]);
+        display->updateMultipleRegions(regions);
+        TEST_ASSERT_TRUE(panelShowsFrame(display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW)));
+    }
+    display->endPartialSession();
+}
+
+static void onRefreshDone(RefreshHandle handle, void* context) {
+    (void)handle;
+    *static_cast<bool*>(context) = true;
+}
+
+static void test_async_refresh_runs_callback() {
+    display->initializeMonochrome();
+    display->displayFullScreenMono(gImage_1, false);
+
+    unsigned long frames_while_busy = 0;
+    bool callback_ran = false;
+    RefreshHandle handle = display->refreshFullAsync(onRefreshDone, &callback_ran);
+    while (display->poll()) {
+        frames_while_busy++;
+        display->bus().delayMs(16);  // One 60 Hz frame of other work
+    }
+    TEST_ASSERT_TRUE(callback_ran);
+    TEST_ASSERT_TRUE(display->isRefreshComplete(handle));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, frames_while_busy);
+    TEST_ASSERT_TRUE(panelShowsFrame(gImage_1));
+}
+
+static void test_update_from_frame_shows_changed_blocks() {
+    display->initializeMonochrome();
+    display->displayFullScreenMono(gImage_1);
+
+    // Invert two blocks, only they are uploaded
+    static unsigned char frame[5000];
+    memcpy(frame, gImage_1, sizeof(frame));
+    for (int row = 60; row < 100; row++) {
+        for (int col = 3; col < 8; col++) {
+            frame[row * 25 + col] ^= 0xFF;
+        }
+        frame[row * 25 + 20] ^= 0x3C;
+    }
+    display->updateFromFrame(frame);
+    TEST_ASSERT_TRUE(panelShowsFrame(frame));
+}
+
+/**
+ * @brief Draw regions into a frame in caller order, independent of the driver's planner
+ *
+ * Data row i of a region lands on frame row (200 - y_start - i); rows past the
+ * panel edge are dropped like the controller does.
+ */
+static void composeRegions(unsigned char* frame, const PartialRegion* regions, size_t count) {
+    for (size_t r = 0; r < count; r++) {
+        const PartialRegion& region = regions[r];
+        unsigned int row_bytes = region.width / 8;
+        for (unsigned int i = 0; i < region.height; i++) {
+            int row = 200 - (int)region.y_start - (int)i;
+            if (row >= 0) {
+                memcpy(&frame[row * 25 + region.x_start / 8], region.data + i * row_bytes, row_bytes);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Merge the clock's edge digit with a region below it and check RAM 0x24 and the panel
+ */
+static void checkEdgeRegions(bool shadow) {
+    // PartialRegion(136, 200, ...) from main.cpp: only its first row is on the panel
+    static const PartialRegion regions[2] = {
+        PartialRegion(136, 200, 64, 32, Num[3]),
+        PartialRegion(136, 160, 64, 32, Num[5]),
+    };
+    static unsigned char black[5000];
+    static unsigned char frame[5000];
+    memset(black, 0x00, sizeof(black));
+    memcpy(frame, black, sizeof(frame));
+    composeRegions(frame, regions, 2);
+
+    if (!shadow) {
+        display->disableShadowBuffer();
+    }
+    display->initializeMonochrome();
+    display->setPartialRefreshBase(black);
+    TEST_ASSERT_TRUE(display->updateRegions(regions, 2));
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_BW, frame));
+    TEST_ASSERT_TRUE(panelShowsFrame(frame));
+}
+
+static void test_update_regions_clips_edge_region_with_shadow() {
+    checkEdgeRegions(true);
+}
+
+static void test_update_regions_clips_edge_region_without_shadow() {
+    checkEdgeRegions(false);
+}
+
+static void test_update_regions_keeps_caller_order() {
+    // The second region overlaps the first and must be drawn over it
+    static const PartialRegion regions[2] = {
+        PartialRegion(0, 30, 64, 20, Num[1]),
+        PartialRegion(0, 20, 64, 32, Num[2]),
+    };
+    static unsigned char black[5000];
+    static unsigned char frame[5000];
+    memset(black, 0x00, sizeof(black));
+    memcpy(frame, black, sizeof(frame));
+    composeRegions(frame, regions, 2);
+
+    display->initializeMonochrome();
+    display->setPartialRefreshBase(black);
+    TEST_ASSERT_TRUE(display->updateRegions(regions, 2));
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_BW, frame));
+    TEST_ASSERT_TRUE(panelShowsFrame(frame));
+}
+
+static void test_calibration_leaves_controller_ram_untouched() {
+    display->initializeMonochrome();
+    display->setPartialRefreshBase(gImage_2);
+    TransferCostModel before = display->getCostModel();
+
+    // Calibration bytes go out with CS released; SimBus traffic takes no virtual time
+    const TransferCostModel& after = display->calibrateCostModel();
+    TEST_ASSERT_EQUAL_FLOAT(before.byte_us, after.byte_us);
+    TEST_ASSERT_EQUAL_FLOAT(before.transaction_us, after.transaction_us);
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_BW, gImage_2));
+    TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_RED, gImage_2));
+}
+
+static void test_update_regions_syncs_stale_old_plane() {
+    // After a 0x24-only image the old plane is stale and must be synced before the partial waveform
+    static const PartialRegion regions[2] = {
+        PartialRegion(0,  32, 64, 32, Num[7]),
+        PartialRegion(136, 200, 64, 32, Num[4]),
+    };
+    display->initializeMonochrome();
+    display->displayFullScreenMono(gImage_2);
+    display->displayFullScreenMono(gImage_basemap);
+    display->updateRegions(regions, 2);
+    TEST_ASSERT_TRUE(panelShowsFrame(display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW)));
+}
+
+static void test_update_partial_region_syncs_stale_old_plane() {
+    display->initializeMonochrome();
+    display->displayFullScreenMono(gImage_2);
+    display->displayFullScreenMono(gImage_1);
+    display->updatePartialRegion(40, 52, Num[2], 64, 32);
+    TEST_ASSERT_TRUE(panelShowsFrame(display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW)));
+}
+
+void runRefreshTests() {
+    RUN_TEST(test_clear_screen_shows_white);
+    RUN_TEST(test_partial_base_loads_both_planes);
+    RUN_TEST(test_clock_digits_in_partial_session);
+    RUN_TEST(test_async_refresh_runs_callback);
+    RUN_TEST(test_update_from_frame_shows_changed_blocks);
+    RUN_TEST(test_update_regions_clips_edge_region_with_shadow);
+    RUN_TEST(test_update_regions_clips_edge_region_without_shadow);
+    RUN_TEST(test_update_regions_keeps_caller_order);
+    RUN_TEST(test_calibration_leaves_controller_ram_untouched);
+    RUN_TEST(test_update_regions_syncs_stale_old_plane);
+    RUN_TEST(test_update_partial_region_syncs_stale_old_plane);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test_service.cpp
+ * @brief Display service queue, mailbox and auto pattern fill
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "test_support.h"
+#include "BMO_Expressions.h"
+#include "GDEH0154D67_Service.h"
+#include "GDEH0154D67_Mailbox.h"
+#include "generated/bmo_face_regions.h"
+
+/**
+ * @brief Expression switch queued as a display service job
+ */
+struct ExpressionJob {
+    BmoExpressionEngine* engine;
+    BmoExpression expression;
+};
+
+static void runExpressionJob(void* context) {
+    ExpressionJob* job = static_cast<ExpressionJob*>(context);
+    job->engine->setExpression(*display, job->expression);
+}
+
+static void test_service_coalesces_expression_burst() {
+    typedef GDEH0154D67_Service<SimDisplay> Service;
+    static ExpressionJob jobs[20];
+    BmoExpressionEngine engine;
+    Service service(*display);
+
+    showMonoSmile();
+    unsigned long refreshes_before = panel->refreshCount();
+    for (unsigned int i = 0; i < 20; i++) {
+        jobs[i].engine = &engine;
+        jobs[i].expression = (BmoExpression)(i % BMO_EXPRESSION_COUNT);
+        service.pushJob(runExpressionJob, &jobs[i], Service::KEY_USER);
+    }
+
+    // A burst of jobs under one key collapses to the newest one
+    TEST_ASSERT_EQUAL_UINT32(1, service.processPending());
+    TEST_ASSERT_EQUAL_UINT32(20 - service.queueCapacity(), service.stats().rejected);
+    TEST_ASSERT_EQUAL(jobs[service.queueCapacity() - 1].expression, engine.current());
+    TEST_ASSERT_EQUAL_UINT32(refreshes_before + 1, panel->refreshCount());
+}
+
+static void test_mailbox_merges_posts_during_refresh() {
+    // Expressions posted while the first refresh runs are merged into one more refresh
+    static const BmoExpression burst[] = {
+        BMO_EXPRESSION_HAPPY, BMO_EXPRESSION_SURPRISED, BMO_EXPRESSION_WINKING,
+        BMO_EXPRESSION_GAMING, BMO_EXPRESSION_CONFUSED, BMO_EXPRESSION_MUSICAL,
+    };
+    static unsigned char expected[5000];
+    GDEH0154D67_Mailbox<SimDisplay> mailbox(*display);
+
+    showMonoSmile();
+    memcpy(expected, display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW), sizeof(expected));
+    unsigned long refreshes_before = panel->refreshCount();
+    TEST_ASSERT_TRUE_MESSAGE(mailbox.begin(), "Mailbox needs a valid shadow");
+    for (BmoExpression expression : burst) {
+        const FacePatchList& full = BmoExpressionEngine::expression(expression);
+        TEST_ASSERT_TRUE_MESSAGE(mailbox.postFaceRegions(full.patches, full.count), display->getLastError());
+        applyPatches(expected, full);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(mailbox.flush(), display->getLastError());
+
+    TEST_ASSERT_EQUAL_UINT32(2, mailbox.stats().commits);
+    TEST_ASSERT_EQUAL_UINT32(refreshes_before + 2, panel->refreshCount());
+    TEST_ASSERT_EQUAL_MEMORY(expected, mailbox.pendingFrame(), sizeof(expected));
+    TEST_ASSERT_TRUE(panelShowsFrame(expected));
+}
+
+static void test_fill_rect_blanks_mouth() {
+    // Blank the mouth black, then white, without sending pixel data
+    static unsigned char frame[5000];
+    FrameRect mouth(BMO_FACE_MOUTH.x_start_byte, BMO_FACE_MOUTH.x_end_byte, BMO_FACE_MOUTH.row_start, BMO_FACE_MOUTH.row_end);
+
+    showMonoSmile();
+    memcpy(frame, display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW), sizeof(frame));
+    for (unsigned int pass = 0; pass < 2; pass++) {
+        bool white = pass == 1;
+        for (unsigned int row = mouth.row_start; row <= mouth.row_end; row++) {
+            memset(&frame[row * 25 + mouth.x_start_byte], white ? 0xFF : 0x00, mouth.x_end_byte - mouth.x_start_byte + 1);
+        }
+        TEST_ASSERT_TRUE(display->fillRect(mouth, white));
+        TEST_ASSERT_TRUE(panelShowsFrame(frame));
+    }
+}
+
+void runServiceTests() {
+    RUN_TEST(test_service_coalesces_expression_burst);
+    RUN_TEST(test_mailbox_merges_posts_during_refresh);
+    RUN_TEST(test_fill_rect_blanks_mouth);
+}
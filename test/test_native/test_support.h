@@ -0,0 +1,51 @@
+/**
+ * @file test_support.h
+ * @brief Shared fixture for the host-native driver tests
+ *
+ * Every test runs against a fresh SSD1681Emulator and GDEH0154D67<SimBus>
+ * created by setUp(); tearDown() checks that the emulator saw no protocol
+ * errors and that the driver's shadow matches controller RAM.
+ */
+
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include "GDEH0154D67_Display.h"
+#include "SSD1681_Emulator.h"
+#include "BMO_Face.h"
+
+typedef GDEH0154D67<SimBus> SimDisplay;
+
+extern SimDisplay* display;
+extern SSD1681Emulator* panel;
+
+/**
+ * @brief Check the panel pixel by pixel against a 1bpp frame
+ */
+bool panelShowsFrame(const unsigned char* frame);
+
+/**
+ * @brief Check one controller RAM plane against a 1bpp frame
+ * @param plane SSD1681Emulator::PLANE_BW (0x24) or PLANE_RED (0x26)
+ */
+bool ramPlaneEquals(unsigned int plane, const unsigned char* frame);
+
+/**
+ * @brief Copy the rows of every patch into a 1bpp frame
+ */
+void applyPatches(unsigned char* frame, const FacePatchList& patches);
+
+/**
+ * @brief Initialize monochrome mode and show the compressed smile face
+ *
+ * Leaves a valid shadow, the starting point for the region-based updates.
+ */
+void showMonoSmile();
+
+void runRefreshTests();
+void runImageTests();
+void runFaceTests();
+void runServiceTests();
+void runWaveformTests();
+
+#endif // TEST_SUPPORT_H
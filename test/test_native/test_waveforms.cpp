@@ -0,0 +1,85 @@
+/**
+ * @file test_waveforms.cpp
+ * @brief Init command tables, fast waveforms and mono/gray mode switching
+ */
+
+#include <unity.h>
+
+#include "test_support.h"
+#include "Ap_29demo.h"
+#include "BMO_Expressions.h"
+#include "generated/gray_planes.h"
+
+static_assert(SSD1681Emulator::validSequence(GDEH0154D67_Base::INIT_SEQUENCE_MONO),
+              "Monochrome init sequence has a wrong argument count");
+static_assert(SSD1681Emulator::validSequence(GDEH0154D67_Base::INIT_SEQUENCE_GRAY),
+              "4-gray init sequence has a wrong argument count");
+
+static void test_fast_full_refresh_uses_fast_waveform() {
+    // Forced-temperature waveform, same image, shorter BUSY
+    showMonoSmile();
+    unsigned long fast_start = display->bus().millis();
+    display->refreshFull(FULL_REFRESH_FAST);
+    unsigned long fast_ms = display->bus().millis() - fast_start;
+    TEST_ASSERT_TRUE(panel->fastWaveformLoaded());
+    TEST_ASSERT_LESS_THAN_UINT32(panel->timing().full_refresh_ms, fast_ms);
+    TEST_ASSERT_TRUE(panelShowsFrame(display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW)));
+}
+
+static void test_fast_partial_loads_lut_once_per_session() {
+    // The custom LUT is loaded once per session and reused by every blink
+    static const BmoExpression blinks[] = {
+        BMO_EXPRESSION_THINKING, BMO_EXPRESSION_NEUTRAL, BMO_EXPRESSION_THINKING, BMO_EXPRESSION_NEUTRAL,
+    };
+    const unsigned long blink_count = sizeof(blinks) / sizeof(blinks[0]);
+    BmoExpressionEngine engine;
+
+    showMonoSmile();
+    display->setPartialWaveform(PARTIAL_WAVEFORM_FAST);
+    display->beginPartialSession();
+    unsigned long lut_loads_before = panel->lutLoadCount();
+    unsigned long blink_start = display->bus().millis();
+    for (BmoExpression expression : blinks) {
+        TEST_ASSERT_TRUE_MESSAGE(engine.setExpression(*display, expression), display->getLastError());
+    }
+    unsigned long blink_ms = (display->bus().millis() - blink_start) / blink_count;
+    display->endPartialSession();
+    display->setPartialWaveform(PARTIAL_WAVEFORM_OTP);
+
+    TEST_ASSERT_EQUAL_UINT32(1, panel->lutLoadCount() - lut_loads_before);
+    TEST_ASSERT_LESS_THAN_UINT32(panel->timing().partial_refresh_ms, blink_ms);
+    TEST_ASSERT_TRUE(panelShowsFrame(display->getShadowPlane(GDEH0154D67_Base::PLANE_NEW)));
+}
+
+static void test_mode_switch_alternates_without_reset() {
+    display->initializeMonochrome();
+    unsigned long resets_before = panel->hardwareResetCount();
+    for (int round = 0; round < 2; round++) {
+        display->switchMode(DISPLAY_MODE_GRAY);
+        display->displayFullScreen4Gray(gImage_11);
+        TEST_ASSERT_TRUE(panel->customLutLoaded());
+        TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_BW, gray_planes_gImage_11.ram_24));
+        TEST_ASSERT_TRUE(ramPlaneEquals(SSD1681Emulator::PLANE_RED, gray_planes_gImage_11.ram_26));
+
+        display->switchMode(DISPLAY_MODE_MONO);
+        display->displayFullScreenMono(gImage_1);
+        TEST_ASSERT_TRUE(panelShowsFrame(gImage_1));
+    }
+    TEST_ASSERT_EQUAL_UINT32(resets_before, panel->hardwareResetCount());
+}
+
+static void test_gray_lut_restored_after_mono_refresh() {
+    // A mono refresh in gray mode loads the OTP LUT; the next gray image must restore the gray LUT
+    display->initialize4Grayscale();
+    display->refreshFull();
+    display->switchMode(DISPLAY_MODE_GRAY);
+    display->displayFullScreen4Gray(gImage_11);
+    TEST_ASSERT_TRUE(panel->customLutLoaded());
+}
+
+void runWaveformTests() {
+    RUN_TEST(test_fast_full_refresh_uses_fast_waveform);
+    RUN_TEST(test_fast_partial_loads_lut_once_per_session);
+    RUN_TEST(test_mode_switch_alternates_without_reset);
+    RUN_TEST(test_gray_lut_restored_after_mono_refresh);
+}